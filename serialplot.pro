@@ -66,12 +66,19 @@ SOURCES += \
     src/streamchannel.cpp \
     src/channelinfomodel.cpp \
     src/ringbuffer.cpp \
+    src/limitstree.cpp \
     src/indexbuffer.cpp \
     src/linindexbuffer.cpp \
     src/readonlybuffer.cpp \
+    src/xringbuffer.cpp \
+    src/multiringbuffer.cpp \
+    src/historyfile.cpp \
+    src/historybuffer.cpp \
+    src/compressedhistory.cpp \
     src/framebufferseries.cpp \
     src/numberformatbox.cpp \
     src/endiannessbox.cpp \
+    src/deviceclockbox.cpp \
     src/abstractreader.cpp \
     src/binarystreamreader.cpp \
     src/binarystreamreadersettings.cpp \
@@ -81,16 +88,28 @@ SOURCES += \
     src/demoreadersettings.cpp \
     src/framedreader.cpp \
     src/framedreadersettings.cpp \
+    src/packetreader.cpp \
+    src/packetreadersettings.cpp \
     src/plotmanager.cpp \
     src/plotmenu.cpp \
     src/barplot.cpp \
     src/barchart.cpp \
     src/barscaledraw.cpp \
     src/numberformat.cpp \
+    src/sampledecoder.cpp \
+    src/framelayout.cpp \
+    src/messagetable.cpp \
+    src/varintdecoder.cpp \
+    src/numberparser.cpp \
+    src/labelindex.cpp \
+    src/checksum.cpp \
     src/updatechecker.cpp \
     src/versionnumber.cpp \
     src/updatecheckdialog.cpp \
     src/samplepack.cpp \
+    src/samplepackpool.cpp \
+    src/capturetime.cpp \
+    src/deviceclock.cpp \
     src/source.cpp \
     src/sink.cpp \
     src/samplecounter.cpp \
@@ -123,6 +142,7 @@ HEADERS += \
     src/plotcontrolpanel.h \
     src/numberformatbox.h \
     src/endiannessbox.h \
+    src/deviceclockbox.h \
     src/framedreadersettings.h \
     src/abstractreader.h \
     src/binarystreamreader.h \
@@ -131,9 +151,18 @@ HEADERS += \
     src/asciireader.h \
     src/demoreader.h \
     src/framedreader.h \
+    src/packetreader.h \
+    src/packetreadersettings.h \
     src/plotmanager.h \
     src/setting_defines.h \
     src/numberformat.h \
+    src/sampledecoder.h \
+    src/framelayout.h \
+    src/messagetable.h \
+    src/varintdecoder.h \
+    src/numberparser.h \
+    src/labelindex.h \
+    src/checksum.h \
     src/recordpanel.h \
     src/updatechecker.h \
     src/updatecheckdialog.h \
@@ -148,12 +177,22 @@ HEADERS += \
     src/defines.h \
     src/indexbuffer.h \
     src/ledwidget.h \
+    src/limitstree.h \
     src/linindexbuffer.h \
     src/plotmenu.h \
     src/readonlybuffer.h \
+    src/xringbuffer.h \
+    src/multiringbuffer.h \
+    src/history.h \
+    src/historyfile.h \
+    src/historybuffer.h \
+    src/compressedhistory.h \
     src/ringbuffer.h \
     src/samplecounter.h \
     src/samplepack.h \
+    src/samplepackpool.h \
+    src/capturetime.h \
+    src/deviceclock.h \
     src/scrollbar.h \
     src/scrollzoomer.h \
     src/sink.h \
@@ -175,7 +214,9 @@ FORMS += \
     src/plotcontrolpanel.ui \
     src/numberformatbox.ui \
     src/endiannessbox.ui \
+    src/deviceclockbox.ui \
     src/framedreadersettings.ui \
+    src/packetreadersettings.ui \
     src/binarystreamreadersettings.ui \
     src/asciireadersettings.ui \
     src/recordpanel.ui \
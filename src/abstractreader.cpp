@@ -18,12 +18,19 @@
 */
 
 #include "abstractreader.h"
+#include "capturetime.h"
+
+/// Weight of the latest measurement in sample interval estimate
+static const double INTERVAL_SMOOTHING = 0.125;
 
 AbstractReader::AbstractReader(QIODevice* device, QObject* parent) :
     QObject(parent)
 {
     _device = device;
     bytesRead = 0;
+    readTime = -1;
+    lastStampTime = -1;
+    sampleInterval = 0;
 }
 
 void AbstractReader::pause(bool enabled)
@@ -35,6 +42,9 @@ void AbstractReader::enable(bool enabled)
 {
     if (enabled)
     {
+        // rate may be different from the last time
+        lastStampTime = -1;
+        sampleInterval = 0;
         QObject::connect(_device, &QIODevice::readyRead,
                          this, &AbstractReader::onDataReady);
     }
@@ -47,9 +57,29 @@ void AbstractReader::enable(bool enabled)
 
 void AbstractReader::onDataReady()
 {
+    readTime = captureTime();
     bytesRead += readData();
 }
 
+void AbstractReader::stamp(SamplePack& samples)
+{
+    // samples of a read are spread over the time since the last one
+    if (lastStampTime >= 0 && readTime > lastStampTime)
+    {
+        double interval = double(readTime - lastStampTime) / samples.numSamples();
+        if (sampleInterval > 0)
+        {
+            sampleInterval += (interval - sampleInterval) * INTERVAL_SMOOTHING;
+        }
+        else
+        {
+            sampleInterval = interval;
+        }
+    }
+    lastStampTime = readTime;
+    samples.setTimestamp(readTime, sampleInterval);
+}
+
 unsigned AbstractReader::getBytesRead()
 {
     unsigned r = bytesRead;
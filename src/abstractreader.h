@@ -26,6 +26,7 @@
 #include <QTimer>
 
 #include "source.h"
+#include "samplepackpool.h"
 
 /**
  * All reader classes must inherit this class.
@@ -46,8 +47,8 @@ public:
     /// 'disabled'.
     virtual void enable(bool enabled = true);
 
-    /// None of the current readers support X channel at the moment
-    bool hasX() const final { return false; };
+    /// Readers don't provide X data unless they re-implement this
+    bool hasX() const override { return false; };
 
     /// Read and 'zero' the byte counter
     unsigned getBytesRead();
@@ -55,6 +56,9 @@ public:
 signals:
     // TODO: should we keep this?
     void numOfChannelsChanged(unsigned);
+    /// Signaled when reader learns the name of a channel from
+    /// incoming data. Emitted after the number of channels is updated.
+    void channelNameChanged(unsigned channel, QString name);
 
 public slots:
     /**
@@ -73,6 +77,21 @@ protected:
     /// paused in `readData()`
     bool paused;
 
+    /// Readers should take packs from this pool and recycle them
+    /// after feeding out, to avoid allocating for each read.
+    SamplePackPool packPool;
+
+    /// Capture time (see `captureTime()`) of the current read. Set
+    /// before `readData()` is called.
+    qint64 readTime;
+
+    /**
+     * Stamps the pack with `readTime` as the time of its last sample
+     * and updates the sample interval estimate. Readers should call
+     * this before feeding out.
+     */
+    void stamp(SamplePack& samples);
+
     /**
      * Called when `readyRead` is signaled by the device. This is
      * where the implementors should read the data and return the
@@ -82,6 +101,8 @@ protected:
 
 private:
     unsigned bytesRead;
+    qint64 lastStampTime;       ///< `readTime` of the last stamped pack
+    double sampleInterval;      ///< smoothed estimate in ns, `0` if unknown
 
 private slots:
     void onDataReady();
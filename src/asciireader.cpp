@@ -18,7 +18,12 @@
 */
 
 #include <QtDebug>
+#include <algorithm>
+#include <limits>
+#include <string.h>
 
+#include "defines.h"
+#include "numberparser.h"
 #include "asciireader.h"
 
 /// If set to this value number of channels is determined from input
@@ -31,28 +36,57 @@ AsciiReader::AsciiReader(QIODevice* device, QObject* parent) :
 
     _numChannels = _settingsWidget.numOfChannels();
     autoNumOfChannels = (_numChannels == NUMOFCHANNELS_AUTO);
-    delimiter = _settingsWidget.delimiter();
+    delimiter = QString(_settingsWidget.delimiter()).toUtf8();
+
+    labeled = _settingsWidget.isLabeled();
+    keepMissingValues = _settingsWidget.keepsMissingValues();
+    clearLabels();
 
     connect(&_settingsWidget, &AsciiReaderSettings::numOfChannelsChanged,
-            [this](unsigned value)
-            {
-                _numChannels = value;
-                updateNumChannels(); // TODO: setting numchannels = 0, should remove all buffers
-                                     // do we want this?
-                autoNumOfChannels = (_numChannels == NUMOFCHANNELS_AUTO);
-                if (!autoNumOfChannels)
-                {
-                    emit numOfChannelsChanged(value);
-                }
-            });
+            this, &AsciiReader::onNumOfChannelsChanged);
 
     connect(&_settingsWidget, &AsciiReaderSettings::delimiterChanged,
             [this](QChar d)
             {
-                delimiter = d;
+                delimiter = QString(d).toUtf8();
+                clearLabels();
+            });
+
+    connect(&_settingsWidget, &AsciiReaderSettings::labeledChanged,
+            [this](bool enabled)
+            {
+                labeled = enabled;
+                clearLabels();
+                // restore the number of channels setting
+                if (!enabled) onNumOfChannelsChanged(_settingsWidget.numOfChannels());
+            });
+
+    connect(&_settingsWidget, &AsciiReaderSettings::keepMissingValuesChanged,
+            [this](bool enabled)
+            {
+                keepMissingValues = enabled;
             });
 }
 
+void AsciiReader::onNumOfChannelsChanged(unsigned value)
+{
+    _numChannels = value;
+    updateNumChannels(); // TODO: setting numchannels = 0, should remove all buffers
+                         // do we want this?
+    autoNumOfChannels = (_numChannels == NUMOFCHANNELS_AUTO);
+    if (!autoNumOfChannels)
+    {
+        emit numOfChannelsChanged(value);
+    }
+}
+
+void AsciiReader::clearLabels()
+{
+    labels.clear();
+    numNamedLabels = 0;
+    std::fill_n(lastValues, MAX_NUM_CHANNELS, std::numeric_limits<double>::quiet_NaN());
+}
+
 QWidget* AsciiReader::settingsWidget()
 {
     return &_settingsWidget;
@@ -70,21 +104,79 @@ void AsciiReader::enable(bool enabled)
     if (enabled)
     {
         firstReadAfterEnable = true;
+        window.clear();
     }
 
     AbstractReader::enable(enabled);
 }
 
+/// Returns true for white space characters that are trimmed
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+/// Removes white space from both ends of the range
+static inline void trim(const char*& begin, const char*& end)
+{
+    while (begin < end && isSpace(*begin)) begin++;
+    while (end > begin && isSpace(*(end-1))) end--;
+}
+
+/// Returns the position of the first `delimiter` in the range or `end`
+static const char* findDelimiter(const char* begin, const char* end,
+                                 const QByteArray& delimiter)
+{
+    const unsigned size = delimiter.size();
+    if (!size) return end;
+
+    // find candidates with (vectorized) `memchr`, then compare the rest
+    const char* p = begin;
+    while ((p = (const char*) memchr(p, delimiter[0], end - p)))
+    {
+        if ((unsigned) (end - p) < size) break;
+        if (size == 1 || memcmp(p, delimiter.constData(), size) == 0) return p;
+        p++;
+    }
+    return end;
+}
+
 unsigned AsciiReader::readData()
 {
-    unsigned numBytesRead = 0;
+    // append all available bytes to the window
+    unsigned oldSize = window.size();
+    qint64 available = _device->bytesAvailable();
+    window.resize(oldSize + available);
+    qint64 numRead = _device->read(window.data() + oldSize, available);
+    if (numRead < 0) numRead = 0;
+    window.resize(oldSize + numRead);
+
+    const char* data = window.constData();
+    const char* end = data + window.size();
+
+    // number of complete lines is the upper limit of number of samples
+    unsigned numLines = 0;
+    for (const char* p = data; (p = (const char*) memchr(p, '\n', end - p)); p++)
+    {
+        numLines++;
+    }
 
-    while(_device->canReadLine())
+    // keep the incomplete line until rest of it arrives
+    if (numLines == 0)
     {
-        QByteArray bytes = _device->readLine();
-        QString line = QString(bytes);
-        numBytesRead += bytes.size();
+        return numRead;
+    }
+
+    // all lines are parsed directly into a single pack
+    SamplePack samples = packPool.take(numLines, numChannels());
+    unsigned ns = 0;            // number of parsed samples in `samples`
+    unsigned lineIndex = 0;
+    double values[MAX_NUM_CHANNELS];
 
+    const char* line = data;
+    const char* nl;
+    for (; (nl = (const char*) memchr(line, '\n', end - line)); line = nl + 1, lineIndex++)
+    {
         // discard only once when we just started reading
         if (firstReadAfterEnable)
         {
@@ -98,71 +190,226 @@ unsigned AsciiReader::readData()
             continue;
         }
 
-        // parse data
-        line = line.trimmed();
+        const char* lineBegin = line;
+        const char* lineEnd = nl;
+        trim(lineBegin, lineEnd);
 
         // Note: When data coming from pseudo terminal is buffered by
         // system CR is converted to LF for some reason. This causes
         // empty lines in the input when the port is just opened.
-        if (line.isEmpty())
+        if (lineBegin == lineEnd)
         {
             continue;
         }
 
-        const SamplePack* samples = parseLine(line);
-        if (samples != nullptr) {
-            // update number of channels if in auto mode
-            if (autoNumOfChannels ) {
-                unsigned nc = samples->numChannels();
-                if (nc != _numChannels) {
-                    _numChannels = nc;
-                    updateNumChannels();
-                    // TODO: is `numOfChannelsChanged` signal still used?
-                    emit numOfChannelsChanged(nc);
-                }
+        unsigned nc = labeled ?
+            parseLabeledLine(lineBegin, lineEnd, values) :
+            parseLine(lineBegin, lineEnd, values);
+        if (!nc) continue;
+
+        if (nc != _numChannels)
+        {
+            if (!autoNumOfChannels && !labeled)
+            {
+                qWarning() << "Line parsing error: invalid number of channels!";
+                qWarning() << "Read line: " << QByteArray(lineBegin, lineEnd - lineBegin);
+                continue;
             }
 
-            Q_ASSERT(samples->numChannels() == _numChannels);
+            // commit samples with previous number of channels
+            feedSamples(samples, ns);
+            packPool.recycle(std::move(samples));
+
+            _numChannels = nc;
+            updateNumChannels();
+            // TODO: is `numOfChannelsChanged` signal still used?
+            emit numOfChannelsChanged(nc);
+
+            samples = packPool.take(numLines - lineIndex, nc);
+            ns = 0;
+        }
 
-            // commit data
-            feedOut(*samples);
-            delete samples;
+        // name the newly learned channels
+        for (; labeled && numNamedLabels < nc; numNamedLabels++)
+        {
+            emit channelNameChanged(numNamedLabels,
+                                    QString::fromUtf8(labels.label(numNamedLabels)));
+        }
+
+        Q_ASSERT(samples.numChannels() == _numChannels);
+
+        for (unsigned ci = 0; ci < nc; ci++)
+        {
+            samples.data(ci)[ns] = values[ci];
         }
+        ns++;
     }
 
-    return numBytesRead;
+    // commit data
+    feedSamples(samples, ns);
+    packPool.recycle(std::move(samples));
+
+    // keep the incomplete line
+    window.remove(0, line - data);
+
+    return numRead;
 }
 
-SamplePack* AsciiReader::parseLine(const QString& line) const
+unsigned AsciiReader::parseLine(const char* begin, const char* end, double* values) const
 {
-    auto separatedValues = line.split(delimiter, QString::SkipEmptyParts);
-    unsigned numComingChannels = separatedValues.length();
+    const unsigned delimSize = delimiter.size();
 
-    // check number of channels (skipped if auto num channels is enabled)
-    if ((!numComingChannels) || (!autoNumOfChannels && numComingChannels != _numChannels))
+    unsigned numComingChannels = 0;
+    const char* p = begin;
+    while (p < end)
+    {
+        // find the end of the field
+        const char* fieldEnd = findDelimiter(p, end, delimiter);
+
+        const char* fieldBegin = p;
+        p = fieldEnd + (fieldEnd == end ? 0 : delimSize);
+        trim(fieldBegin, fieldEnd);
+
+        // skip empty fields
+        if (fieldBegin == fieldEnd) continue;
+
+        if (numComingChannels == MAX_NUM_CHANNELS)
+        {
+            qWarning() << "Line parsing error: invalid number of channels!";
+            qWarning() << "Read line: " << QByteArray(begin, end - begin);
+            return 0;
+        }
+
+        if (!parseNumber(fieldBegin, fieldEnd, values[numComingChannels]))
+        {
+            qWarning() << "Data parsing error for channel: " << numComingChannels;
+            qWarning() << "Read line: " << QByteArray(begin, end - begin);
+            return 0;
+        }
+        numComingChannels++;
+    }
+
+    if (!numComingChannels)
     {
         qWarning() << "Line parsing error: invalid number of channels!";
-        qWarning() << "Read line: " << line;
-        return nullptr;
+        qWarning() << "Read line: " << QByteArray(begin, end - begin);
     }
 
-    // parse data per channel
-    auto samples = new SamplePack(1, numComingChannels);
-    for (unsigned ci = 0; ci < numComingChannels; ci++)
+    return numComingChannels;
+}
+
+unsigned AsciiReader::parseLabeledLine(const char* begin, const char* end, double* values)
+{
+    const unsigned delimSize = delimiter.size();
+
+    // start with values of missing channels
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    for (unsigned ci = 0; ci < labels.size(); ci++)
     {
-        bool ok;
-        samples->data(ci)[0] = separatedValues[ci].toDouble(&ok);
-        if (!ok)
+        values[ci] = keepMissingValues ? lastValues[ci] : missing;
+    }
+
+    // new labels are added only after the whole line is parsed, so
+    // that a rejected line doesn't leave its labels behind
+    struct NewLabel
+    {
+        const char* label;
+        unsigned size;
+    };
+    NewLabel newLabels[MAX_NUM_CHANNELS];
+    unsigned numNew = 0;
+
+    const char* p = begin;
+    while (p < end)
+    {
+        const char* fieldEnd = findDelimiter(p, end, delimiter);
+        const char* fieldBegin = p;
+        p = fieldEnd + (fieldEnd == end ? 0 : delimSize);
+        trim(fieldBegin, fieldEnd);
+
+        // skip empty fields
+        if (fieldBegin == fieldEnd) continue;
+
+        // split label and value
+        const char* eq = (const char*) memchr(fieldBegin, '=', fieldEnd - fieldBegin);
+        if (eq == nullptr)
         {
-            qWarning() << "Data parsing error for channel: " << ci;
-            qWarning() << "Read line: " << line;
+            qWarning() << "Line parsing error: missing '=' in column!";
+            qWarning() << "Read line: " << QByteArray(begin, end - begin);
+            return 0;
+        }
+        const char* labelBegin = fieldBegin;
+        const char* labelEnd = eq;
+        const char* valueBegin = eq + 1;
+        const char* valueEnd = fieldEnd;
+        trim(labelBegin, labelEnd);
+        trim(valueBegin, valueEnd);
+
+        // find the channel, it may be a new label seen earlier in this line
+        const unsigned labelSize = labelEnd - labelBegin;
+        int ci = labels.find(labelBegin, labelSize);
+        for (unsigned k = 0; ci < 0 && k < numNew; k++)
+        {
+            if (newLabels[k].size == labelSize &&
+                memcmp(newLabels[k].label, labelBegin, labelSize) == 0)
+            {
+                ci = labels.size() + k;
+            }
+        }
+        if (ci < 0)
+        {
+            if (labels.size() + numNew == MAX_NUM_CHANNELS)
+            {
+                qWarning() << "Line parsing error: too many labels!";
+                qWarning() << "Read line: " << QByteArray(begin, end - begin);
+                return 0;
+            }
+            ci = labels.size() + numNew;
+            newLabels[numNew++] = {labelBegin, labelSize};
+            values[ci] = missing;
+        }
 
-            delete samples;
-            return nullptr;
+        if (!parseNumber(valueBegin, valueEnd, values[ci]))
+        {
+            qWarning() << "Data parsing error for channel: "
+                       << QByteArray(labelBegin, labelSize);
+            qWarning() << "Read line: " << QByteArray(begin, end - begin);
+            return 0;
         }
     }
 
-    return samples;
+    // line is valid, learn the new labels
+    for (unsigned k = 0; k < numNew; k++)
+    {
+        labels.insert(newLabels[k].label, newLabels[k].size);
+    }
+
+    std::copy_n(values, labels.size(), lastValues);
+
+    return labels.size();
+}
+
+void AsciiReader::feedSamples(SamplePack& samples, unsigned ns)
+{
+    if (ns == 0) return;
+
+    if (ns == samples.numSamples())
+    {
+        stamp(samples);
+        feedOut(samples);
+        return;
+    }
+
+    // some lines were skipped, copy into a pack of exact size
+    unsigned nc = samples.numChannels();
+    SamplePack part = packPool.take(ns, nc);
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        memcpy(part.data(ci), samples.data(ci), ns * sizeof(double));
+    }
+    stamp(part);
+    feedOut(part);
+    packPool.recycle(std::move(part));
 }
 
 void AsciiReader::saveSettings(QSettings* settings)
@@ -26,6 +26,8 @@
 #include "samplepack.h"
 #include "abstractreader.h"
 #include "asciireadersettings.h"
+#include "labelindex.h"
+#include "defines.h"
 
 class AsciiReader : public AbstractReader
 {
@@ -46,20 +48,47 @@ private:
     unsigned _numChannels;
     /// number of channels will be determined from incoming data
     unsigned autoNumOfChannels;
-    QChar delimiter; ///< selected column delimiter
+    QByteArray delimiter; ///< selected column delimiter, UTF-8 encoded
+    bool labeled;         ///< columns are in `label=value` format
+    bool keepMissingValues; ///< repeat last value for missing labels, otherwise NaN
+    LabelIndex labels;    ///< channel index of labels, in order of appearance
+    double lastValues[MAX_NUM_CHANNELS]; ///< last received value of labeled channels
+    unsigned numNamedLabels; ///< number of labels that are sent as channel names
 
     bool firstReadAfterEnable = false;
 
+    /// Bytes read from device but not parsed yet, an incomplete line
+    /// after a read.
+    QByteArray window;
+
     unsigned readData() override;
 
-private slots:
+    /**
+     * Parses the line between `begin` and `end` into `values` which
+     * should have room for `MAX_NUM_CHANNELS`. Line shouldn't contain
+     * the new line character.
+     *
+     * Returns the number of values, `0` in case of error.
+     */
+    unsigned parseLine(const char* begin, const char* end, double* values) const;
 
     /**
-     * Parses given line and returns sample pack.
+     * Parses a line of `label=value` columns into `values`. Unknown
+     * labels are added as new channels. Values of missing labels are
+     * set to their last value or NaN.
      *
-     * Returns `nullptr` in case of error.
+     * Returns the number of channels (labels), `0` in case of error.
      */
-    SamplePack* parseLine(const QString& line) const;
+    unsigned parseLabeledLine(const char* begin, const char* end, double* values);
+
+    /// Clears learned labels and their last values
+    void clearLabels();
+
+    /// Commits first `ns` samples of the `samples`
+    void feedSamples(SamplePack& samples, unsigned ns);
+
+private slots:
+    void onNumOfChannelsChanged(unsigned value);
 };
 
 #endif // ASCIIREADER_H
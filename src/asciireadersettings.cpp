@@ -49,6 +49,20 @@ AsciiReaderSettings::AsciiReaderSettings(QWidget *parent) :
     connect(ui->leDelimiter, &QLineEdit::textChanged,
             this, &AsciiReaderSettings::customDelimiterChanged);
 
+    connect(ui->cbLabeled, &QCheckBox::toggled,
+            [this](bool checked)
+            {
+                ui->cbMissingValue->setEnabled(checked);
+                ui->spNumOfChannels->setEnabled(!checked);
+                emit labeledChanged(checked);
+            });
+
+    connect(ui->cbMissingValue, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged),
+            [this](int index)
+            {
+                emit keepMissingValuesChanged(index == 0);
+            });
+
     // Note: if directly connected we get a runtime warning on incompatible signal arguments
     connect(ui->spNumOfChannels, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
             [this](int value)
@@ -88,6 +102,16 @@ QChar AsciiReaderSettings::delimiter() const
     }
 }
 
+bool AsciiReaderSettings::isLabeled() const
+{
+    return ui->cbLabeled->isChecked();
+}
+
+bool AsciiReaderSettings::keepsMissingValues() const
+{
+    return ui->cbMissingValue->currentIndex() == 0;
+}
+
 void AsciiReaderSettings::delimiterToggled(bool checked)
 {
     if (!checked) return;
@@ -135,6 +159,10 @@ void AsciiReaderSettings::saveSettings(QSettings* settings)
     settings->setValue(SG_ASCII_Delimiter, delimiterS);
     settings->setValue(SG_ASCII_CustomDelimiter, ui->leDelimiter->text());
 
+    // save label settings
+    settings->setValue(SG_ASCII_Labeled, isLabeled());
+    settings->setValue(SG_ASCII_KeepMissing, keepsMissingValues());
+
     settings->endGroup();
 }
 
@@ -181,5 +209,11 @@ void AsciiReaderSettings::loadSettings(QSettings* settings)
         ui->rbOtherDelimiter->setChecked(true);
     }
 
+    // load label settings
+    ui->cbLabeled->setChecked(
+        settings->value(SG_ASCII_Labeled, isLabeled()).toBool());
+    bool keepMissing = settings->value(SG_ASCII_KeepMissing, keepsMissingValues()).toBool();
+    ui->cbMissingValue->setCurrentIndex(keepMissing ? 0 : 1);
+
     settings->endGroup();
 }
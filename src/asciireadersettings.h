@@ -38,6 +38,11 @@ public:
 
     unsigned numOfChannels() const;
     QChar delimiter() const;
+    /// Columns are in `label=value` format
+    bool isLabeled() const;
+    /// In labeled mode, last value is repeated for missing channels
+    /// instead of a gap (NaN)
+    bool keepsMissingValues() const;
     /// Stores settings into a `QSettings`
     void saveSettings(QSettings* settings);
     /// Loads settings from a `QSettings`.
@@ -47,6 +52,8 @@ signals:
     void numOfChannelsChanged(unsigned);
     /// Signaled only with a valid delimiter
     void delimiterChanged(QChar);
+    void labeledChanged(bool);
+    void keepMissingValuesChanged(bool);
 
 private:
     Ui::AsciiReaderSettings *ui;
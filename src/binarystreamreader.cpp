@@ -17,11 +17,9 @@
   along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <QtEndian>
 #include <QtDebug>
 
 #include "binarystreamreader.h"
-#include "floatswap.h"
 
 BinaryStreamReader::BinaryStreamReader(QIODevice* device, QObject* parent) :
     AbstractReader(device, parent)
@@ -31,6 +29,10 @@ BinaryStreamReader::BinaryStreamReader(QIODevice* device, QObject* parent) :
     skipSampleRequested = false;
 
     _numChannels = _settingsWidget.numOfChannels();
+    clockChannel = -1;
+    onDeviceClockChanged();
+    connect(&_settingsWidget, &BinaryStreamReaderSettings::deviceClockChanged,
+            this, &BinaryStreamReader::onDeviceClockChanged);
     connect(&_settingsWidget, &BinaryStreamReaderSettings::numOfChannelsChanged,
                      this, &BinaryStreamReader::onNumOfChannelsChanged);
 
@@ -38,6 +40,10 @@ BinaryStreamReader::BinaryStreamReader(QIODevice* device, QObject* parent) :
     onNumberFormatChanged(_settingsWidget.numberFormat());
     connect(&_settingsWidget, &BinaryStreamReaderSettings::numberFormatChanged,
             this, &BinaryStreamReader::onNumberFormatChanged);
+    connect(&_settingsWidget, &BinaryStreamReaderSettings::endiannessChanged,
+            this, &BinaryStreamReader::updateDecoder);
+    connect(&_settingsWidget, &BinaryStreamReaderSettings::fractionBitsChanged,
+            this, &BinaryStreamReader::updateDecoder);
 
     // enable skip byte and sample buttons
     connect(&_settingsWidget, &BinaryStreamReaderSettings::skipByteRequested,
@@ -57,60 +63,70 @@ QWidget* BinaryStreamReader::settingsWidget()
     return &_settingsWidget;
 }
 
+void BinaryStreamReader::enable(bool enabled)
+{
+    // device may have been restarted
+    if (enabled) deviceClock.reset();
+    AbstractReader::enable(enabled);
+}
+
 unsigned BinaryStreamReader::numChannels() const
 {
-    return _numChannels;
+    // clock channel is moved to X
+    return clockActive() ? _numChannels - 1 : _numChannels;
+}
+
+bool BinaryStreamReader::hasX() const
+{
+    return clockActive();
+}
+
+bool BinaryStreamReader::clockActive() const
+{
+    return clockChannel >= 0 && unsigned(clockChannel) < _numChannels && _numChannels > 1;
+}
+
+void BinaryStreamReader::onDeviceClockChanged()
+{
+    clockChannel = _settingsWidget.clockChannel();
+    deviceClock.setClock(_settingsWidget.clockTickRate(),
+                         _settingsWidget.clockWrapBits());
+    updateNumChannels();
+    emit numOfChannelsChanged(numChannels());
+}
+
+NumberFormat BinaryStreamReader::sampleFormat() const
+{
+    return _sampleFormat;
 }
 
 void BinaryStreamReader::onNumberFormatChanged(NumberFormat numberFormat)
 {
-    switch(numberFormat)
-    {
-        case NumberFormat_uint8:
-            sampleSize = 1;
-            readSample = &BinaryStreamReader::readSampleAs<quint8>;
-            break;
-        case NumberFormat_int8:
-            sampleSize = 1;
-            readSample = &BinaryStreamReader::readSampleAs<qint8>;
-            break;
-        case NumberFormat_uint16:
-            sampleSize = 2;
-            readSample = &BinaryStreamReader::readSampleAs<quint16>;
-            break;
-        case NumberFormat_int16:
-            sampleSize = 2;
-            readSample = &BinaryStreamReader::readSampleAs<qint16>;
-            break;
-        case NumberFormat_uint32:
-            sampleSize = 4;
-            readSample = &BinaryStreamReader::readSampleAs<quint32>;
-            break;
-        case NumberFormat_int32:
-            sampleSize = 4;
-            readSample = &BinaryStreamReader::readSampleAs<qint32>;
-            break;
-        case NumberFormat_float:
-            sampleSize = 4;
-            readSample = &BinaryStreamReader::readSampleAs<float>;
-            break;
-        case NumberFormat_INVALID:
-            Q_ASSERT(1); // never
-            break;
-    }
+    _sampleFormat = numberFormat;
+    sampleSize = ::sampleSize(numberFormat);
+    updateDecoder();
+    updateSampleFormat();
+}
+
+void BinaryStreamReader::updateDecoder()
+{
+    decoder = SampleDecoder(_sampleFormat, _settingsWidget.endianness(), _numChannels,
+                            _settingsWidget.fractionBits());
 }
 
 void BinaryStreamReader::onNumOfChannelsChanged(unsigned value)
 {
     _numChannels = value;
+    deviceClock.reset();
+    updateDecoder();
     updateNumChannels();
-    emit numOfChannelsChanged(value);
+    emit numOfChannelsChanged(numChannels());
 }
 
 unsigned BinaryStreamReader::readData()
 {
     // a package is a set of channel data like {CHAN0_SAMPLE, CHAN1_SAMPLE...}
-    unsigned packageSize = sampleSize * _numChannels;
+    unsigned packageSize = decoder.packageSize();
     unsigned bytesAvailable = _device->bytesAvailable();
     unsigned totalRead = 0;
 
@@ -140,43 +156,31 @@ unsigned BinaryStreamReader::readData()
 
     totalRead += numBytesToRead;
 
-    if (paused)
-    {
-        // read and discard data
-        _device->read(numBytesToRead);
-        return totalRead;
-    }
-
-    // actual reading
-    SamplePack samples(numOfPackagesToRead, _numChannels);
-    for (unsigned i = 0; i < numOfPackagesToRead; i++)
-    {
-        for (unsigned ci = 0; ci < _numChannels; ci++)
-        {
-            samples.data(ci)[i] = (this->*readSample)();
-        }
-    }
-    feedOut(samples);
-
-    return totalRead;
-}
-
-template<typename T> double BinaryStreamReader::readSampleAs()
-{
-    T data;
+    // read all packages at once
+    readBuffer.resize(numBytesToRead);
+    _device->read(readBuffer.data(), numBytesToRead);
 
-    _device->read((char*) &data, sizeof(data));
+    // if paused just discard data
+    if (paused) return totalRead;
 
-    if (_settingsWidget.endianness() == LittleEndian)
+    const unsigned numSamples = numOfPackagesToRead * decoder.packageSamples();
+    SamplePack samples = packPool.take(numSamples, _numChannels);
+    decoder.decode(readBuffer.constData(), numOfPackagesToRead, samples, 0);
+    stamp(samples);
+    if (clockActive())
     {
-        data = qFromLittleEndian(data);
+        SamplePack timed = packPool.take(numSamples, _numChannels - 1, true);
+        deviceClock.apply(samples, clockChannel, timed);
+        feedOut(timed);
+        packPool.recycle(std::move(timed));
     }
     else
     {
-        data = qFromBigEndian(data);
+        feedOut(samples);
     }
+    packPool.recycle(std::move(samples));
 
-    return double(data);
+    return totalRead;
 }
 
 void BinaryStreamReader::saveSettings(QSettings* settings)
@@ -24,6 +24,8 @@
 
 #include "abstractreader.h"
 #include "binarystreamreadersettings.h"
+#include "sampledecoder.h"
+#include "deviceclock.h"
 
 /**
  * Reads a simple stream of samples in binary form from the
@@ -36,7 +38,12 @@ class BinaryStreamReader : public AbstractReader
 public:
     explicit BinaryStreamReader(QIODevice* device, QObject *parent = 0);
     QWidget* settingsWidget();
+    /// Resets the device clock when enabling
+    void enable(bool enabled = true) override;
     unsigned numChannels() const;
+    /// Provides X data when a device clock channel is selected
+    bool hasX() const override;
+    NumberFormat sampleFormat() const override;
     /// Stores settings into a `QSettings`
     void saveSettings(QSettings* settings);
     /// Loads settings from a `QSettings`.
@@ -45,26 +52,32 @@ public:
 private:
     BinaryStreamReaderSettings _settingsWidget;
     unsigned _numChannels;
-    unsigned sampleSize;
+    NumberFormat _sampleFormat;
+    unsigned sampleSize;        ///< rounded up for bit packed formats, used to skip a sample
     bool skipByteRequested;
     bool skipSampleRequested;
 
-    /// points to the readSampleAs function for currently selected number format
-    double (BinaryStreamReader::*readSample)();
+    /// decodes samples in currently selected format
+    SampleDecoder decoder;
+    /// packages are read into this buffer before decoding
+    QByteArray readBuffer;
+    /// index of the device clock channel, `-1` if none
+    int clockChannel;
+    /// maps the clock channel to X data
+    DeviceClock deviceClock;
 
-    /**
-     * Reads 1 sample from the device in given format.
-     *
-     * @note Device should already have enough bytes present before
-     * calling this function.
-     */
-    template<typename T> double readSampleAs();
+    /// Returns true if the selected clock channel exists
+    bool clockActive() const;
 
     unsigned readData() override;
 
 private slots:
     void onNumberFormatChanged(NumberFormat numberFormat);
     void onNumOfChannelsChanged(unsigned value);
+    /// Re-creates the `decoder` for current settings
+    void updateDecoder();
+    /// Re-creates the `deviceClock` for current settings
+    void onDeviceClockChanged();
 };
 
 #endif // BINARYSTREAMREADER_H
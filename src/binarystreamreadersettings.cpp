@@ -42,6 +42,15 @@ BinaryStreamReaderSettings::BinaryStreamReaderSettings(QWidget *parent) :
     connect(ui->nfBox, SIGNAL(selectionChanged(NumberFormat)),
             this, SIGNAL(numberFormatChanged(NumberFormat)));
 
+    connect(ui->endiBox, SIGNAL(selectionChanged(Endianness)),
+            this, SIGNAL(endiannessChanged(Endianness)));
+
+    connect(ui->nfBox, SIGNAL(fractionBitsChanged(unsigned)),
+            this, SIGNAL(fractionBitsChanged(unsigned)));
+
+    connect(ui->clockBox, &DeviceClockBox::changed,
+            this, &BinaryStreamReaderSettings::deviceClockChanged);
+
     connect(ui->pbSkipByte, SIGNAL(clicked()), this, SIGNAL(skipByteRequested()));
     connect(ui->pbSkipSample, SIGNAL(clicked()), this, SIGNAL(skipSampleRequested()));
 }
@@ -66,6 +75,26 @@ Endianness BinaryStreamReaderSettings::endianness()
     return ui->endiBox->currentSelection();
 }
 
+unsigned BinaryStreamReaderSettings::fractionBits()
+{
+    return ui->nfBox->fractionBits();
+}
+
+int BinaryStreamReaderSettings::clockChannel()
+{
+    return ui->clockBox->channel();
+}
+
+double BinaryStreamReaderSettings::clockTickRate()
+{
+    return ui->clockBox->tickRate();
+}
+
+unsigned BinaryStreamReaderSettings::clockWrapBits()
+{
+    return ui->clockBox->wrapBits();
+}
+
 void BinaryStreamReaderSettings::saveSettings(QSettings* settings)
 {
     settings->beginGroup(SettingGroup_Binary);
@@ -73,6 +102,10 @@ void BinaryStreamReaderSettings::saveSettings(QSettings* settings)
     settings->setValue(SG_Binary_NumberFormat, numberFormatToStr(numberFormat()));
     settings->setValue(SG_Binary_Endianness,
                        endianness() == LittleEndian ? "little" : "big");
+    settings->setValue(SG_Binary_FractionBits, fractionBits());
+    settings->setValue(SG_Binary_ClockChannel, clockChannel());
+    settings->setValue(SG_Binary_ClockTickRate, clockTickRate());
+    settings->setValue(SG_Binary_ClockWrapBits, clockWrapBits());
     settings->endGroup();
 }
 
@@ -103,5 +136,17 @@ void BinaryStreamReaderSettings::loadSettings(QSettings* settings)
         ui->endiBox->setSelection(BigEndian);
     } // else don't change
 
+    // load fraction bits
+    ui->nfBox->setFractionBits(
+        settings->value(SG_Binary_FractionBits, fractionBits()).toUInt());
+
+    // load device clock
+    ui->clockBox->setTickRate(
+        settings->value(SG_Binary_ClockTickRate, clockTickRate()).toDouble());
+    ui->clockBox->setWrapBits(
+        settings->value(SG_Binary_ClockWrapBits, clockWrapBits()).toUInt());
+    ui->clockBox->setChannel(
+        settings->value(SG_Binary_ClockChannel, clockChannel()).toInt());
+
     settings->endGroup();
 }
@@ -25,6 +25,7 @@
 
 #include "numberformatbox.h"
 #include "endiannessbox.h"
+#include "deviceclockbox.h"
 
 namespace Ui {
 class BinaryStreamReaderSettings;
@@ -41,6 +42,14 @@ public:
     unsigned numOfChannels();
     NumberFormat numberFormat();
     Endianness endianness();
+    /// Number of fraction bits for fixed point number formats
+    unsigned fractionBits();
+    /// Index of the device clock channel, `-1` if none
+    int clockChannel();
+    /// Nominal tick rate of the device clock in Hz
+    double clockTickRate();
+    /// Device clock counter width in bits, `0` if it doesn't wrap
+    unsigned clockWrapBits();
 
     /// Stores settings into a `QSettings`
     void saveSettings(QSettings* settings);
@@ -50,6 +59,9 @@ public:
 signals:
     void numOfChannelsChanged(unsigned);
     void numberFormatChanged(NumberFormat);
+    void endiannessChanged(Endianness);
+    void fractionBitsChanged(unsigned);
+    void deviceClockChanged();
     void skipByteRequested();
     void skipSampleRequested();
 
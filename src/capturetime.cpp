@@ -0,0 +1,55 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QElapsedTimer>
+#include <QDateTime>
+
+#include "capturetime.h"
+
+namespace
+{
+struct CaptureClock
+{
+    QElapsedTimer timer;
+    qint64 epochOffset;         ///< epoch time when `timer` is started, in ns
+
+    CaptureClock()
+    {
+        epochOffset = QDateTime::currentMSecsSinceEpoch() * 1000000;
+        timer.start();
+    }
+};
+}
+
+/// Clock is started at first use
+static CaptureClock& captureClock()
+{
+    static CaptureClock clock;
+    return clock;
+}
+
+qint64 captureTime()
+{
+    return captureClock().timer.nsecsElapsed();
+}
+
+qint64 captureTimeToEpoch(qint64 time)
+{
+    return captureClock().epochOffset + time;
+}
@@ -0,0 +1,39 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CAPTURETIME_H
+#define CAPTURETIME_H
+
+#include <QtGlobal>
+
+/**
+ * Returns the current time of a monotonic clock in nanoseconds. Used
+ * to stamp the incoming data. Values are only meaningful relative to
+ * each other.
+ */
+qint64 captureTime();
+
+/**
+ * Converts a capture time to nanoseconds since epoch. Offset between
+ * the clocks is measured once, so changes of the system clock don't
+ * affect the results.
+ */
+qint64 captureTimeToEpoch(qint64 time);
+
+#endif // CAPTURETIME_H
@@ -0,0 +1,174 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QMap>
+
+#include "checksum.h"
+
+static QMap<ChecksumType, QString> typeNames({
+        {ChecksumType_Sum8, "sum8"},
+        {ChecksumType_CRC8, "crc8"},
+        {ChecksumType_CRC16_CCITT, "crc16-ccitt"},
+        {ChecksumType_CRC16_Modbus, "crc16-modbus"},
+        {ChecksumType_CRC32, "crc32"}
+    });
+
+QString checksumTypeToStr(ChecksumType type)
+{
+    return typeNames.value(type);
+}
+
+ChecksumType strToChecksumType(QString str)
+{
+    return typeNames.key(str, ChecksumType_INVALID);
+}
+
+/// Parameters of a checksum type
+struct ChecksumParams
+{
+    unsigned width;
+    quint32 poly;
+    quint32 init;
+    quint32 xorOut;
+    bool reflect;
+};
+
+static ChecksumParams params(ChecksumType type)
+{
+    switch (type)
+    {
+        case ChecksumType_Sum8:
+            return {8, 0, 0, 0, false};
+        case ChecksumType_CRC8:
+            return {8, 0x07, 0, 0, false};
+        case ChecksumType_CRC16_CCITT:
+            return {16, 0x1021, 0xFFFF, 0, false};
+        case ChecksumType_CRC16_Modbus:
+            return {16, 0x8005, 0xFFFF, 0, true};
+        case ChecksumType_CRC32:
+            return {32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true};
+        default:
+            Q_ASSERT(false);
+            return {8, 0, 0, 0, false};
+    }
+}
+
+/// Reverses the order of lowest `width` bits of `value`
+static quint32 reflectBits(quint32 value, unsigned width)
+{
+    quint32 r = 0;
+    for (unsigned i = 0; i < width; i++)
+    {
+        r = (r << 1) | (value & 1);
+        value >>= 1;
+    }
+    return r;
+}
+
+Checksum::Checksum(ChecksumType type)
+{
+    auto p = params(type);
+    _type = type;
+    _init = p.init;
+    _xorOut = p.xorOut;
+    _reflect = p.reflect;
+    _width = p.width;
+    buildTable(p.poly);
+}
+
+Checksum::Checksum(ChecksumType type, quint32 init, quint32 xorOut, bool reflect)
+{
+    auto p = params(type);
+    quint32 mask = p.width == 32 ? 0xFFFFFFFF : (1u << p.width) - 1;
+    _type = type;
+    _init = init & mask;
+    _xorOut = xorOut & mask;
+    _reflect = reflect;
+    _width = p.width;
+    buildTable(p.poly);
+}
+
+void Checksum::buildTable(quint32 poly)
+{
+    if (_type == ChecksumType_Sum8) return; // table isn't used
+
+    if (_reflect)
+    {
+        // register is kept reflected, shifted towards LSB
+        quint32 rpoly = reflectBits(poly, _width);
+        for (unsigned i = 0; i < 256; i++)
+        {
+            quint32 r = i;
+            for (int b = 0; b < 8; b++)
+            {
+                r = (r & 1) ? (r >> 1) ^ rpoly : r >> 1;
+            }
+            table[i] = r;
+        }
+    }
+    else
+    {
+        // register is kept aligned to MSB of 32 bits, regardless of width
+        quint32 apoly = poly << (32 - _width);
+        for (unsigned i = 0; i < 256; i++)
+        {
+            quint32 r = i << 24;
+            for (int b = 0; b < 8; b++)
+            {
+                r = (r & 0x80000000) ? (r << 1) ^ apoly : r << 1;
+            }
+            table[i] = r;
+        }
+    }
+}
+
+quint32 Checksum::calculate(const char* data, unsigned size) const
+{
+    auto bytes = reinterpret_cast<const uchar*>(data);
+
+    if (_type == ChecksumType_Sum8)
+    {
+        quint32 sum = _init;
+        for (unsigned i = 0; i < size; i++)
+        {
+            sum += bytes[i];
+        }
+        return (sum ^ _xorOut) & 0xFF;
+    }
+
+    if (_reflect)
+    {
+        quint32 r = reflectBits(_init, _width);
+        for (unsigned i = 0; i < size; i++)
+        {
+            r = table[(r ^ bytes[i]) & 0xFF] ^ (r >> 8);
+        }
+        return r ^ _xorOut;
+    }
+    else
+    {
+        const unsigned shift = 32 - _width;
+        quint32 r = _init << shift;
+        for (unsigned i = 0; i < size; i++)
+        {
+            r = table[(r >> 24) ^ bytes[i]] ^ (r << 8);
+        }
+        return (r >> shift) ^ _xorOut;
+    }
+}
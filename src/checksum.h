@@ -0,0 +1,86 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <QString>
+#include <QtGlobal>
+
+enum ChecksumType
+{
+    ChecksumType_Sum8,          ///< 8 bits sum of bytes
+    ChecksumType_CRC8,          ///< polynomial 0x07
+    ChecksumType_CRC16_CCITT,   ///< polynomial 0x1021
+    ChecksumType_CRC16_Modbus,  ///< polynomial 0x8005
+    ChecksumType_CRC32,         ///< polynomial 0x04C11DB7
+    ChecksumType_INVALID        ///< used for error cases
+};
+
+/// Convert `ChecksumType` to string for representation
+QString checksumTypeToStr(ChecksumType type);
+
+/// Convert string to `ChecksumType`
+ChecksumType strToChecksumType(QString str);
+
+/**
+ * Calculates a checksum or CRC of a block of bytes.
+ *
+ * CRCs are calculated with a 256 entry lookup table, 1 byte at a
+ * time. Table is built at construction, so a `Checksum` should be
+ * created when settings change and then used for all frames.
+ *
+ * Parameters follow the usual CRC model: `init` is the starting value
+ * of the register, `xorOut` is applied to the final value and
+ * `reflect` selects the bit reversed (LSB first) variant for both
+ * input and output.
+ */
+class Checksum
+{
+public:
+    explicit Checksum(ChecksumType type = ChecksumType_Sum8);
+    Checksum(ChecksumType type, quint32 init, quint32 xorOut, bool reflect);
+
+    /// Returns the checksum with standard parameters of `type`
+    /// (CRC-8, CRC-16/CCITT-FALSE, CRC-16/MODBUS and CRC-32)
+    static Checksum preset(ChecksumType type) {return Checksum(type);};
+
+    ChecksumType type() const {return _type;};
+    quint32 init() const {return _init;};
+    quint32 xorOut() const {return _xorOut;};
+    bool reflect() const {return _reflect;};
+
+    /// Size of the checksum in bytes
+    unsigned size() const {return _width / 8;};
+
+    /// Calculates the checksum of `size` bytes starting from `data`
+    quint32 calculate(const char* data, unsigned size) const;
+
+private:
+    ChecksumType _type;
+    quint32 _init;
+    quint32 _xorOut;
+    bool _reflect;
+    unsigned _width;            ///< in bits
+    quint32 table[256];
+
+    void buildTable(quint32 poly);
+};
+
+#endif // CHECKSUM_H
@@ -0,0 +1,420 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+#include "compressedhistory.h"
+
+/// Limits of an empty block, it doesn't change the result when merged
+static const Range EMPTY_LIMITS = {std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity()};
+
+/// Integers bigger than this (in magnitude) are not delta encoded,
+/// all integers up to this are exactly representable by double
+static const double MAX_DELTA_INTEGER = 4503599627370496.0; // 2^52
+
+static inline Range merge(const Range& a, const Range& b)
+{
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+static Range scan(const double* data, unsigned n)
+{
+    Range lim = EMPTY_LIMITS;
+    for (unsigned i = 0; i < n; i++)
+    {
+        if (data[i] > lim.end) lim.end = data[i];
+        if (data[i] < lim.start) lim.start = data[i];
+    }
+    return lim;
+}
+
+static inline quint64 toBits(double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline double fromBits(quint64 bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// Writes values of arbitrary bit width to an array, starting from LSB
+class BitWriter
+{
+public:
+    explicit BitWriter(QVector<quint64>* words) : _words(words), pos(0) {}
+
+    void write(quint64 value, unsigned nbits)
+    {
+        if (nbits == 0) return;
+        if (nbits < 64) value &= (quint64(1) << nbits) - 1;
+
+        unsigned offset = pos % 64;
+        if (offset == 0) _words->append(0);
+        _words->last() |= value << offset;
+        if (offset + nbits > 64)
+        {
+            _words->append(value >> (64 - offset));
+        }
+        pos += nbits;
+    }
+
+private:
+    QVector<quint64>* _words;
+    unsigned pos;               ///< number of written bits
+};
+
+/// Reads values written by `BitWriter`
+class BitReader
+{
+public:
+    explicit BitReader(const quint64* words) : _words(words), pos(0) {}
+
+    quint64 read(unsigned nbits)
+    {
+        if (nbits == 0) return 0;
+
+        unsigned index = pos / 64;
+        unsigned offset = pos % 64;
+        quint64 value = _words[index] >> offset;
+        if (offset + nbits > 64)
+        {
+            value |= _words[index + 1] << (64 - offset);
+        }
+        if (nbits < 64) value &= (quint64(1) << nbits) - 1;
+        pos += nbits;
+        return value;
+    }
+
+private:
+    const quint64* _words;
+    unsigned pos;               ///< number of read bits
+};
+
+CompressedHistory::CompressedHistory(unsigned nc) :
+    channels(nc)
+{
+    _size = 0;
+    for (auto& ch : channels)
+    {
+        ch.tail.reserve(BLOCK_SIZE);
+        ch.cachedBlock = -1;
+    }
+}
+
+unsigned CompressedHistory::numChannels() const
+{
+    return channels.size();
+}
+
+unsigned CompressedHistory::size() const
+{
+    return _size;
+}
+
+double* CompressedHistory::pendingAt(unsigned ci, unsigned offset, unsigned n)
+{
+    Q_ASSERT(ci < numChannels());
+
+    QVector<double>& pending = channels[ci].pending;
+    if ((unsigned) pending.size() < offset + n)
+    {
+        pending.resize(offset + n);
+    }
+    return pending.data() + offset;
+}
+
+void CompressedHistory::append(unsigned ci, unsigned offset, const double* samples, unsigned n)
+{
+    if (n == 0) return;
+    std::copy(samples, samples + n, pendingAt(ci, offset, n));
+}
+
+void CompressedHistory::append(unsigned ci, unsigned offset, const FrameBuffer* buffer,
+                               unsigned start, unsigned n)
+{
+    if (n == 0) return;
+    buffer->copyRange(start, n, pendingAt(ci, offset, n));
+}
+
+void CompressedHistory::commit(unsigned n)
+{
+    for (auto& ch : channels)
+    {
+        Q_ASSERT((unsigned) ch.pending.size() >= n);
+
+        const double* samples = ch.pending.constData();
+        unsigned done = 0;
+        while (done < n)
+        {
+            unsigned filled = ch.tail.size();
+            unsigned count = std::min(n - done, BLOCK_SIZE - filled);
+            ch.tail.resize(filled + count);
+            std::copy(samples + done, samples + done + count, ch.tail.data() + filled);
+            done += count;
+
+            if ((unsigned) ch.tail.size() == BLOCK_SIZE)
+            {
+                ch.blocks.append(encode(ch.tail.constData()));
+                ch.tail.resize(0);
+            }
+        }
+        ch.pending.resize(0);
+    }
+    _size += n;
+}
+
+void CompressedHistory::clear()
+{
+    for (auto& ch : channels)
+    {
+        ch.blocks.clear();
+        ch.tail.resize(0);
+        ch.pending.resize(0);
+        ch.cachedBlock = -1;
+    }
+    _size = 0;
+}
+
+size_t CompressedHistory::compressedSize() const
+{
+    size_t total = 0;
+    for (auto& ch : channels)
+    {
+        for (auto& block : ch.blocks)
+        {
+            total += sizeof(Block) + block.bits.size() * sizeof(quint64);
+        }
+    }
+    return total;
+}
+
+const double* CompressedHistory::blockData(unsigned ci, unsigned b) const
+{
+    const Channel& ch = channels[ci];
+    if (b == (unsigned) ch.blocks.size())
+    {
+        return ch.tail.constData();
+    }
+
+    if (ch.cachedBlock != (int) b)
+    {
+        ch.cache.resize(BLOCK_SIZE);
+        decode(ch.blocks[b], ch.cache.data());
+        ch.cachedBlock = b;
+    }
+    return ch.cache.constData();
+}
+
+template <typename F>
+void CompressedHistory::forEachPart(unsigned start, unsigned n, F func) const
+{
+    unsigned done = 0;
+    while (done < n)
+    {
+        unsigned i = start + done;
+        unsigned offset = i % BLOCK_SIZE;
+        unsigned count = std::min(n - done, BLOCK_SIZE - offset);
+        func(i / BLOCK_SIZE, offset, done, count);
+        done += count;
+    }
+}
+
+double CompressedHistory::sample(unsigned ci, unsigned i) const
+{
+    Q_ASSERT(ci < numChannels() && i < _size);
+    return blockData(ci, i / BLOCK_SIZE)[i % BLOCK_SIZE];
+}
+
+Range CompressedHistory::limits(unsigned ci, unsigned start, unsigned n) const
+{
+    Q_ASSERT(ci < numChannels());
+    Q_ASSERT(n > 0 && start + n <= _size);
+
+    const Channel& ch = channels[ci];
+    Range lim = EMPTY_LIMITS;
+    forEachPart(start, n, [this, ci, &ch, &lim](unsigned b, unsigned offset,
+                                               unsigned index, unsigned count)
+                {
+                    Q_UNUSED(index);
+                    if (count == BLOCK_SIZE) // whole (compressed) block
+                    {
+                        lim = merge(lim, ch.blocks[b].limits);
+                    }
+                    else
+                    {
+                        lim = merge(lim, scan(blockData(ci, b) + offset, count));
+                    }
+                });
+    return lim;
+}
+
+void CompressedHistory::copyRange(unsigned ci, unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(ci < numChannels());
+    Q_ASSERT(start + n <= _size);
+
+    const Channel& ch = channels[ci];
+    forEachPart(start, n, [this, ci, &ch, out](unsigned b, unsigned offset,
+                                              unsigned index, unsigned count)
+                {
+                    if (count == BLOCK_SIZE && ch.cachedBlock != (int) b)
+                    {
+                        // decode directly, don't pollute the cache
+                        decode(ch.blocks[b], out + index);
+                    }
+                    else
+                    {
+                        const double* src = blockData(ci, b) + offset;
+                        std::copy(src, src + count, out + index);
+                    }
+                });
+}
+
+CompressedHistory::Block CompressedHistory::encode(const double* samples)
+{
+    Block block;
+    block.limits = scan(samples, BLOCK_SIZE);
+    block.width = 0;
+
+    bool integers = true;
+    for (unsigned i = 0; i < BLOCK_SIZE && integers; i++)
+    {
+        integers = samples[i] == trunc(samples[i]) &&
+            fabs(samples[i]) <= MAX_DELTA_INTEGER;
+    }
+
+    BitWriter writer(&block.bits);
+    if (integers)
+    {
+        block.codec = Codec_Delta;
+
+        // zigzag encoded deltas, so that small negative values are small too
+        quint64 zz[BLOCK_SIZE];
+        quint64 all = 0;
+        qint64 prev = qint64(samples[0]);
+        for (unsigned i = 1; i < BLOCK_SIZE; i++)
+        {
+            qint64 value = qint64(samples[i]);
+            qint64 delta = value - prev;
+            zz[i] = (quint64(delta) << 1) ^ quint64(delta >> 63);
+            all |= zz[i];
+            prev = value;
+        }
+        block.width = all ? 64 - qCountLeadingZeroBits(all) : 0;
+
+        writer.write(quint64(qint64(samples[0])), 64);
+        for (unsigned i = 1; i < BLOCK_SIZE; i++)
+        {
+            writer.write(zz[i], block.width);
+        }
+    }
+    else
+    {
+        block.codec = Codec_Xor;
+
+        quint64 prev = toBits(samples[0]);
+        unsigned prevLeading = 64; // no previous window
+        unsigned prevTrailing = 0;
+        writer.write(prev, 64);
+        for (unsigned i = 1; i < BLOCK_SIZE; i++)
+        {
+            quint64 bits = toBits(samples[i]);
+            quint64 x = bits ^ prev;
+            prev = bits;
+
+            if (x == 0)
+            {
+                writer.write(0, 1);
+                continue;
+            }
+
+            unsigned leading = qCountLeadingZeroBits(x);
+            unsigned trailing = qCountTrailingZeroBits(x);
+            writer.write(1, 1);
+            if (leading >= prevLeading && trailing >= prevTrailing)
+            {
+                // fits into the previous window
+                writer.write(0, 1);
+                writer.write(x >> prevTrailing, 64 - prevLeading - prevTrailing);
+            }
+            else
+            {
+                unsigned meaningful = 64 - leading - trailing;
+                writer.write(1, 1);
+                writer.write(leading, 6);
+                writer.write(meaningful - 1, 6);
+                writer.write(x >> trailing, meaningful);
+                prevLeading = leading;
+                prevTrailing = trailing;
+            }
+        }
+    }
+
+    block.bits.squeeze();
+    return block;
+}
+
+void CompressedHistory::decode(const Block& block, double* out)
+{
+    BitReader reader(block.bits.constData());
+
+    if (block.codec == Codec_Delta)
+    {
+        qint64 value = qint64(reader.read(64));
+        out[0] = value;
+        for (unsigned i = 1; i < BLOCK_SIZE; i++)
+        {
+            quint64 zz = reader.read(block.width);
+            value += qint64(zz >> 1) ^ -qint64(zz & 1);
+            out[i] = value;
+        }
+    }
+    else
+    {
+        quint64 bits = reader.read(64);
+        unsigned leading = 0;
+        unsigned trailing = 0;
+        out[0] = fromBits(bits);
+        for (unsigned i = 1; i < BLOCK_SIZE; i++)
+        {
+            if (reader.read(1))
+            {
+                if (reader.read(1))
+                {
+                    leading = reader.read(6);
+                    unsigned meaningful = reader.read(6) + 1;
+                    trailing = 64 - leading - meaningful;
+                }
+                bits ^= reader.read(64 - leading - trailing) << trailing;
+            }
+            out[i] = fromBits(bits);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMPRESSEDHISTORY_H
+#define COMPRESSEDHISTORY_H
+
+#include <QVector>
+#include <stddef.h>
+
+#include "history.h"
+
+/**
+ * `History` that is kept in memory in compressed form.
+ *
+ * Samples of each channel are grouped into blocks of `BLOCK_SIZE`
+ * samples. When a block is filled it's compressed and can be decoded
+ * independently of other blocks:
+ *
+ * - if all samples of the block are integers, differences between
+ *   consecutive samples are zigzag encoded and packed with the
+ *   minimum bit width required by the block,
+ * - otherwise samples are XOR'ed with the previous sample and only
+ *   the meaningful bits are stored (as in Facebook's Gorilla).
+ *
+ * Minimum and maximum of each block is stored uncompressed so limits
+ * are found without decoding. Last decoded block of each channel is
+ * cached, so that sequential reads with `sample()` decode each block
+ * only once. Last, not yet filled block is kept uncompressed.
+ */
+class CompressedHistory : public History
+{
+public:
+    /// Number of samples of a channel in a block
+    static const unsigned BLOCK_SIZE = 1024;
+
+    explicit CompressedHistory(unsigned nc);
+
+    unsigned numChannels() const override;
+    unsigned size() const override;
+    void append(unsigned ci, unsigned offset, const double* samples, unsigned n) override;
+    void append(unsigned ci, unsigned offset, const FrameBuffer* buffer,
+                unsigned start, unsigned n) override;
+    void commit(unsigned n) override;
+    void clear() override;
+    double sample(unsigned ci, unsigned i) const override;
+    Range limits(unsigned ci, unsigned start, unsigned n) const override;
+    void copyRange(unsigned ci, unsigned start, unsigned n, double* out) const override;
+
+    /// Returns the memory used by compressed blocks in bytes
+    size_t compressedSize() const;
+
+private:
+    enum Codec
+    {
+        Codec_Delta,            ///< delta encoding of integers
+        Codec_Xor               ///< XOR encoding of floating point numbers
+    };
+
+    struct Block
+    {
+        Range limits;
+        Codec codec;
+        unsigned width;         ///< bit width of deltas for `Codec_Delta`
+        QVector<quint64> bits;
+    };
+
+    struct Channel
+    {
+        QVector<Block> blocks;  ///< compressed blocks
+        QVector<double> tail;   ///< samples of the last block, not compressed
+        QVector<double> pending; ///< appended but not yet committed samples
+
+        mutable int cachedBlock; ///< index of decoded block in `cache`, -1 if none
+        mutable QVector<double> cache;
+    };
+
+    unsigned _size;
+    QVector<Channel> channels;
+
+    /// Makes room for appending `n` samples at `offset` and returns
+    /// the start of them
+    double* pendingAt(unsigned ci, unsigned offset, unsigned n);
+
+    /// Returns the samples of a block decoding it if necessary. Last
+    /// block (tail) is returned as it is.
+    const double* blockData(unsigned ci, unsigned b) const;
+
+    /// Calls `func(b, offset, index, count)` for each part of `n`
+    /// samples starting from `start` that fall into a single block `b`,
+    /// `offset` being the position of the part in block and `index`
+    /// the number of samples before this part.
+    template <typename F>
+    void forEachPart(unsigned start, unsigned n, F func) const;
+
+    static Block encode(const double* samples);
+    static void decode(const Block& block, double* out);
+};
+
+#endif // COMPRESSEDHISTORY_H
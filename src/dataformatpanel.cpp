@@ -32,6 +32,7 @@ DataFormatPanel::DataFormatPanel(QSerialPort* port, QWidget *parent) :
     bsReader(port, this),
     asciiReader(port, this),
     framedReader(port, this),
+    packetReader(port, this),
     demoReader(port, this)
 {
     ui->setupUi(this);
@@ -46,6 +47,8 @@ DataFormatPanel::DataFormatPanel(QSerialPort* port, QWidget *parent) :
     bsReader.enable();
     ui->rbBinary->setChecked(true);
     ui->horizontalLayout->addWidget(bsReader.settingsWidget(), 1);
+    connect(&bsReader, &AbstractReader::channelNameChanged,
+            this, &DataFormatPanel::channelNameChanged);
 
     // initalize reader selection buttons
     connect(ui->rbBinary, &QRadioButton::toggled, [this](bool checked)
@@ -62,6 +65,11 @@ DataFormatPanel::DataFormatPanel(QSerialPort* port, QWidget *parent) :
             {
                 if (checked) selectReader(&framedReader);
             });
+
+    connect(ui->rbPacket, &QRadioButton::toggled, [this](bool checked)
+            {
+                if (checked) selectReader(&packetReader);
+            });
 }
 
 DataFormatPanel::~DataFormatPanel()
@@ -104,6 +112,7 @@ void DataFormatPanel::enableDemo(bool demoEnabled)
     ui->rbAscii->setDisabled(demoEnabled);
     ui->rbBinary->setDisabled(demoEnabled);
     ui->rbFramed->setDisabled(demoEnabled);
+    ui->rbPacket->setDisabled(demoEnabled);
 }
 
 bool DataFormatPanel::isDemoEnabled() const
@@ -118,6 +127,8 @@ void DataFormatPanel::selectReader(AbstractReader* reader)
 
     // re-connect signals
     disconnect(currentReader, 0, this, 0);
+    connect(reader, &AbstractReader::channelNameChanged,
+            this, &DataFormatPanel::channelNameChanged);
 
     // switch the settings widget
     ui->horizontalLayout->removeWidget(currentReader->settingsWidget());
@@ -152,6 +163,10 @@ void DataFormatPanel::saveSettings(QSettings* settings)
     {
         format = "ascii";
     }
+    else if (selectedReader == &packetReader)
+    {
+        format = "packet";
+    }
     else // framed reader
     {
         format = "custom";
@@ -164,6 +179,7 @@ void DataFormatPanel::saveSettings(QSettings* settings)
     bsReader.saveSettings(settings);
     asciiReader.saveSettings(settings);
     framedReader.saveSettings(settings);
+    packetReader.saveSettings(settings);
 }
 
 void DataFormatPanel::loadSettings(QSettings* settings)
@@ -188,6 +204,11 @@ void DataFormatPanel::loadSettings(QSettings* settings)
     {
         selectReader(&framedReader);
         ui->rbFramed->setChecked(true);
+    }
+    else if (format == "packet")
+    {
+        selectReader(&packetReader);
+        ui->rbPacket->setChecked(true);
     } // else current selection stays
 
     settings->endGroup();
@@ -196,4 +217,5 @@ void DataFormatPanel::loadSettings(QSettings* settings)
     bsReader.loadSettings(settings);
     asciiReader.loadSettings(settings);
     framedReader.loadSettings(settings);
+    packetReader.loadSettings(settings);
 }
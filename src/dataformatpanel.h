@@ -32,6 +32,7 @@
 #include "asciireader.h"
 #include "demoreader.h"
 #include "framedreader.h"
+#include "packetreader.h"
 #include "datarecorder.h"
 
 namespace Ui {
@@ -64,6 +65,8 @@ public slots:
 signals:
     /// Active (selected) reader has changed.
     void sourceChanged(Source* source);
+    /// Active reader has named a channel
+    void channelNameChanged(unsigned channel, QString name);
 
 private:
     Ui::DataFormatPanel *ui;
@@ -73,6 +76,7 @@ private:
     BinaryStreamReader bsReader;
     AsciiReader asciiReader;
     FramedReader framedReader;
+    PacketReader packetReader;
     /// Currently selected reader
     AbstractReader* currentReader;
     /// Disable current reader and enable a another one
@@ -21,9 +21,10 @@
 
 #include <QFileInfo>
 #include <QDir>
-#include <QDateTime>
 #include <QtDebug>
 
+#include "capturetime.h"
+
 DataRecorder::DataRecorder(QObject *parent) :
     QObject(parent),
     fileStream(&file)
@@ -84,25 +85,40 @@ bool DataRecorder::startRecording(QString fileName, QString separator,
 void DataRecorder::feedIn(const SamplePack& data)
 {
     Q_ASSERT(file.isOpen());    // recorder should be disconnected before stopping recording
-    Q_ASSERT(!data.hasX());     // NYI
 
     // check if number of channels has changed during recording and warn
     unsigned numChannels = data.numChannels();
-    if (lastNumChannels != 0 && numChannels != lastNumChannels)
+    bool hasX = data.hasX();
+    unsigned numColumns = numChannels + (hasX ? 1 : 0);
+    if (lastNumChannels != 0 && numColumns != lastNumChannels)
     {
         qWarning() << "Number of channels changed from " << lastNumChannels
-                   << " to " << numChannels <<
+                   << " to " << numColumns <<
             " during recording, CSV file is corrupted but no data will be lost.";
     }
-    lastNumChannels = numChannels;
+    lastNumChannels = numColumns;
 
-    // write data
+    // capture time of the pack, if it's not stamped all rows get current time
     unsigned numSamples = data.numSamples();
+    bool stamped = data.hasTimestamp();
+    qint64 writeTime = 0;
+    if (timestampOpt != TimestampOption::disabled && !stamped)
+    {
+        writeTime = captureTime();
+    }
+
+    // write data
     for (unsigned int i = 0; i < numSamples; i++)
     {
         if (timestampOpt != TimestampOption::disabled)
         {
-            fileStream << formatTimestamp() << _sep;
+            qint64 time = stamped ? data.sampleTime(i) : writeTime;
+            fileStream << formatTimestamp(captureTimeToEpoch(time)) << _sep;
+        }
+        // X (ie. device time) is the first data column
+        if (hasX)
+        {
+            fileStream << data.xData()[i] << _sep;
         }
         for (unsigned ci = 0; ci < numChannels; ci++)
         {
@@ -123,23 +139,22 @@ void DataRecorder::stopRecording()
     lastNumChannels = 0;
 }
 
-QString DataRecorder::formatTimestamp() const
+QString DataRecorder::formatTimestamp(qint64 time) const
 {
     Q_ASSERT(timestampOpt != TimestampOption::disabled);
 
-    qint64 ms;
+    qint64 ms = time / 1000000;
 
     switch (timestampOpt)
     {
         case TimestampOption::seconds:
-            return QString::number(QDateTime::currentSecsSinceEpoch());
+            return QString::number(ms / 1000);
             break;
         case TimestampOption::seconds_precision:
-            ms = QDateTime::currentMSecsSinceEpoch();
-            return QString("%1.%2").arg(ms / 1000).arg(ms % 1000);
+            return QString("%1.%2").arg(ms / 1000).arg(ms % 1000, 3, 10, QChar('0'));
             break;
         case TimestampOption::milliseconds:
-            return QString::number(QDateTime::currentMSecsSinceEpoch());
+            return QString::number(ms);
             break;
         default:
             Q_ASSERT(false);
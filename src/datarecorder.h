@@ -67,7 +67,8 @@ public:
      *
      * @param fileName name of the recording file
      * @param separator column separator
-     * @param channelNames names of the channels for header line, if empty no header line is written
+     * @param channelNames names of the channels for header line, if empty no header line is written.
+     * If stream has X data its name should be the first.
      * @param insertTime enable inserting timestamp
      * @return false if file operation fails (read only etc.)
      */
@@ -100,14 +101,15 @@ protected:
     virtual void feedIn(const SamplePack& data);
 
 private:
-    unsigned lastNumChannels;   ///< used for error message only
+    unsigned lastNumChannels;   ///< including X column, used for error message only
     QFile file;
     QTextStream fileStream;
     QString _sep;
     TimestampOption timestampOpt;
 
     /// Returns formatted timestamp
-    QString formatTimestamp() const;
+    /// @param time nanoseconds since epoch
+    QString formatTimestamp(qint64 time) const;
 
     /// Returns the selected line ending.
     const char* le() const;
@@ -20,6 +20,7 @@
 #include <math.h>
 
 #include "demoreader.h"
+#include "capturetime.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -76,13 +77,16 @@ void DemoReader::demoTimerTimeout()
 
     if (!paused)
     {
-        SamplePack samples(1, _numChannels);
+        SamplePack samples = packPool.take(1, _numChannels);
         for (unsigned ci = 0; ci < _numChannels; ci++)
         {
             // we are calculating the fourier components of square wave
             samples.data(ci)[0] = 4*sin(2*M_PI*double((ci+1)*count)/period)/((2*(ci+1))*M_PI);
         }
+        readTime = captureTime();
+        stamp(samples);
         feedOut(samples);
+        packPool.recycle(std::move(samples));
     }
 }
 
@@ -0,0 +1,167 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+
+#include "deviceclock.h"
+
+/// Minimum weight of the newest point, limits the regression window
+static const double MIN_FIT_WEIGHT = 1. / 256;
+/// Fit is used once its points are spread over this duration (std. deviation, s)
+static const double MIN_FIT_SPAN = 0.5;
+
+DeviceClock::DeviceClock(double tickRate, unsigned wrapBits)
+{
+    lastTime = 0;
+    setClock(tickRate, wrapBits);
+}
+
+void DeviceClock::setClock(double tickRate, unsigned wrapBits)
+{
+    Q_ASSERT(tickRate > 0);
+    Q_ASSERT(wrapBits <= 64);
+
+    nominalPeriod = 1. / tickRate;
+    if (wrapBits == 0)
+    {
+        wrapMask = 0;
+    }
+    else if (wrapBits == 64)
+    {
+        wrapMask = ~quint64(0);
+    }
+    else
+    {
+        wrapMask = (quint64(1) << wrapBits) - 1;
+    }
+    reset();
+}
+
+void DeviceClock::reset()
+{
+    started = false;
+    lastRaw = 0;
+    firstRaw = 0;
+    ticks = 0;
+    origin = 0;
+    baseTime = lastTime;
+    numPoints = 0;
+    meanX = meanY = 0;
+    covXX = covXY = 0;
+}
+
+double DeviceClock::unwrap(double raw)
+{
+    if (wrapMask == 0)
+    {
+        // counter doesn't wrap, only offset to the first value
+        if (!started) firstRaw = raw;
+        ticks = raw - firstRaw;
+        return ticks;
+    }
+
+    quint64 r = quint64(qint64(raw)) & wrapMask;
+    if (started)
+    {
+        ticks += double((r - lastRaw) & wrapMask);
+    }
+    lastRaw = r;
+    return ticks;
+}
+
+void DeviceClock::fit(double x, double y)
+{
+    // exponentially weighted mean and covariance, weight of the first
+    // points is `1/n` so that they are averaged evenly
+    numPoints++;
+    double w = 1. / numPoints;
+    if (w < MIN_FIT_WEIGHT) w = MIN_FIT_WEIGHT;
+
+    double dx = x - meanX;
+    double dy = y - meanY;
+    meanX += w * dx;
+    meanY += w * dy;
+    covXX = (1 - w) * (covXX + w * dx * dx);
+    covXY = (1 - w) * (covXY + w * dx * dy);
+}
+
+double DeviceClock::tickPeriod() const
+{
+    if (numPoints > 1 && covXX * nominalPeriod * nominalPeriod >= MIN_FIT_SPAN * MIN_FIT_SPAN)
+    {
+        return covXY / covXX;
+    }
+    return nominalPeriod;
+}
+
+void DeviceClock::apply(const SamplePack& in, unsigned channel, SamplePack& out)
+{
+    const unsigned ns = in.numSamples();
+
+    Q_ASSERT(channel < in.numChannels());
+    Q_ASSERT(out.numSamples() == ns && out.hasX());
+    Q_ASSERT(out.numChannels() + 1 == in.numChannels());
+
+    // copy other channels
+    for (unsigned ci = 0, oi = 0; ci < in.numChannels(); ci++)
+    {
+        if (ci == channel) continue;
+        memcpy(out.data(oi++), in.data(ci), ns * sizeof(double));
+    }
+    out.copyTimestamp(in);
+
+    // unwrap counter values into X
+    const double* raw = in.data(channel);
+    double* x = out.xData();
+    for (unsigned i = 0; i < ns; i++)
+    {
+        x[i] = unwrap(raw[i]);
+        started = true;
+    }
+
+    // update the fit with the last sample, it's the one that is captured
+    if (in.hasTimestamp())
+    {
+        // first sample of the first pack is mapped to `baseTime`, its
+        // capture time is extrapolated with the nominal period
+        if (numPoints == 0)
+        {
+            origin = in.timestamp() - qint64((x[ns-1] - x[0]) * nominalPeriod * 1e9);
+        }
+        fit(x[ns-1], (in.timestamp() - origin) * 1e-9);
+    }
+
+    // map ticks to time
+    double period = tickPeriod();
+    if (period <= 0) period = nominalPeriod;
+    double offset = baseTime + meanY - period * meanX;
+
+    // if the fit moved backwards shift the whole pack, so that samples
+    // keep their spacing and X doesn't decrease across packs
+    double first = offset + period * x[0];
+    if (first < lastTime) offset += lastTime - first;
+
+    for (unsigned i = 0; i < ns; i++)
+    {
+        double t = offset + period * x[i];
+        // only if the counter itself goes backwards
+        if (t < lastTime) t = lastTime;
+        x[i] = lastTime = t;
+    }
+}
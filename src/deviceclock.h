@@ -0,0 +1,95 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEVICECLOCK_H
+#define DEVICECLOCK_H
+
+#include <QtGlobal>
+
+#include "samplepack.h"
+
+/**
+ * Maps the tick counter of a device to host time.
+ *
+ * Counter values are unwrapped and fitted to the capture times of the
+ * packs with an exponentially weighted linear regression, so that the
+ * drift of the device crystal relative to the host clock is
+ * absorbed. Fit is updated once per pack with its last sample, the
+ * nominal tick rate is used until it covers enough time.
+ *
+ * Mapped times are in seconds since the first sample and never
+ * decrease, so that they can be used as X data. When the fit moves
+ * backwards, the whole pack is shifted to start at the last output
+ * instead of clamping its samples.
+ */
+class DeviceClock
+{
+public:
+    /**
+     * @param tickRate nominal counter frequency in Hz
+     * @param wrapBits width of the counter in bits, `0` if it doesn't wrap
+     */
+    explicit DeviceClock(double tickRate = 1000, unsigned wrapBits = 0);
+
+    /// Changes the clock parameters, also resets.
+    void setClock(double tickRate, unsigned wrapBits);
+
+    /**
+     * Forgets the counter and the fit, for example when device is
+     * restarted. Mapped time continues from the last output so that X
+     * data keeps increasing.
+     */
+    void reset();
+
+    /**
+     * Converts the counter channel `channel` of `in` into the X data
+     * of `out`. Other channels are copied in order, capture time is
+     * kept.
+     *
+     * @note `out` must have `in.numSamples()` samples, 1 channel less
+     * than `in` and X data.
+     */
+    void apply(const SamplePack& in, unsigned channel, SamplePack& out);
+
+    /// Currently fitted tick period in seconds
+    double tickPeriod() const;
+
+private:
+    double nominalPeriod;       ///< `1 / tickRate`
+    quint64 wrapMask;           ///< `0` if counter doesn't wrap
+    bool started;
+    quint64 lastRaw;            ///< last counter value as read, masked
+    double firstRaw;            ///< first counter value, if it doesn't wrap
+    double ticks;               ///< unwrapped counter value, relative to first sample
+    qint64 origin;              ///< estimated capture time of the first sample, ns
+    double lastTime;            ///< last mapped time, output is clamped to it
+    double baseTime;            ///< `lastTime` at the last reset
+
+    // regression state, x: ticks, y: host time in seconds since `origin`
+    unsigned numPoints;
+    double meanX, meanY;
+    double covXX, covXY;
+
+    /// Returns unwrapped tick count of a counter value
+    double unwrap(double raw);
+    /// Adds a point to the regression
+    void fit(double x, double y);
+};
+
+#endif // DEVICECLOCK_H
@@ -0,0 +1,87 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "deviceclockbox.h"
+#include "ui_deviceclockbox.h"
+
+#include "utils.h"
+
+DeviceClockBox::DeviceClockBox(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::DeviceClockBox)
+{
+    ui->setupUi(this);
+
+    ui->spTickRate->setEnabled(false);
+    ui->spWrapBits->setEnabled(false);
+
+    connect(ui->spChannel, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
+            [this](int value)
+            {
+                ui->spTickRate->setEnabled(value > 0);
+                ui->spWrapBits->setEnabled(value > 0);
+                emit changed();
+            });
+    connect(ui->spTickRate, SELECT<double>::OVERLOAD_OF(&QDoubleSpinBox::valueChanged),
+            [this](double)
+            {
+                emit changed();
+            });
+    connect(ui->spWrapBits, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
+            [this](int)
+            {
+                emit changed();
+            });
+}
+
+DeviceClockBox::~DeviceClockBox()
+{
+    delete ui;
+}
+
+int DeviceClockBox::channel() const
+{
+    // spin box shows channels starting from 1, 0 is "none"
+    return ui->spChannel->value() - 1;
+}
+
+double DeviceClockBox::tickRate() const
+{
+    return ui->spTickRate->value();
+}
+
+unsigned DeviceClockBox::wrapBits() const
+{
+    return ui->spWrapBits->value();
+}
+
+void DeviceClockBox::setChannel(int channel)
+{
+    ui->spChannel->setValue(channel < 0 ? 0 : channel + 1);
+}
+
+void DeviceClockBox::setTickRate(double rate)
+{
+    ui->spTickRate->setValue(rate);
+}
+
+void DeviceClockBox::setWrapBits(unsigned bits)
+{
+    ui->spWrapBits->setValue(bits);
+}
@@ -0,0 +1,57 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DEVICECLOCKBOX_H
+#define DEVICECLOCKBOX_H
+
+#include <QWidget>
+
+namespace Ui {
+class DeviceClockBox;
+}
+
+/// Selects a channel that carries the tick counter of the device
+class DeviceClockBox : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceClockBox(QWidget *parent = 0);
+    ~DeviceClockBox();
+
+    /// Index of the clock channel, `-1` if none is selected
+    int channel() const;
+    /// Nominal tick rate in Hz
+    double tickRate() const;
+    /// Counter width in bits, `0` if it doesn't wrap
+    unsigned wrapBits() const;
+
+    void setChannel(int channel);
+    void setTickRate(double rate);
+    void setWrapBits(unsigned bits);
+
+signals:
+    /// Signaled when any of the clock settings is changed
+    void changed();
+
+private:
+    Ui::DeviceClockBox *ui;
+};
+
+#endif // DEVICECLOCKBOX_H
@@ -28,6 +28,16 @@ struct Range
     double start, end;
 };
 
+/// A read only view of a contiguous array of samples
+template <typename T>
+struct SpanOf
+{
+    const T* data;
+    unsigned size;
+};
+
+typedef SpanOf<double> Span;
+
 /// Abstract base class for all frame buffers.
 class FrameBuffer
 {
@@ -40,6 +50,16 @@ public:
     virtual double sample(unsigned i) const = 0;
     /// Returns minimum and maximum of the buffer values.
     virtual Range limits() const = 0;
+    /// Returns minimum and maximum of `n` samples starting from index
+    /// `start`.
+    ///
+    /// @important `n` must be bigger than 0 and `(start + n)` must be
+    /// smaller or equal to `size()`.
+    virtual Range limits(unsigned start, unsigned n) const = 0;
+    /// Copies `n` samples starting from index `start` to `out` array.
+    ///
+    /// @important `(start + n)` must be smaller or equal to `size()`.
+    virtual void copyRange(unsigned start, unsigned n, double* out) const = 0;
 };
 
 /// Common base class for index and writable frame buffers
@@ -55,6 +75,7 @@ public:
 /// Abstract base class for writable frame buffers
 class WFrameBuffer : public ResizableBuffer
 {
+public:
     /// Add samples to the buffer
     virtual void addSamples(double* samples, unsigned n) = 0;
     /// Reset all data to 0
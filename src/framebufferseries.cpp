@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <algorithm>
 #include "framebufferseries.h"
 
 FrameBufferSeries::FrameBufferSeries(const XFrameBuffer* x, const FrameBuffer* y)
@@ -26,7 +27,7 @@ FrameBufferSeries::FrameBufferSeries(const XFrameBuffer* x, const FrameBuffer* y
     _y = y;
 
     int_index_start = 0;
-    int_index_end = _y->size();
+    int_index_end = _y->size() - 1;
 }
 
 void FrameBufferSeries::setX(const XFrameBuffer* x)
@@ -34,6 +35,11 @@ void FrameBufferSeries::setX(const XFrameBuffer* x)
     _x = x;
 }
 
+void FrameBufferSeries::setY(const FrameBuffer* y)
+{
+    _y = y;
+}
+
 size_t FrameBufferSeries::size() const
 {
     return int_index_end - int_index_start + 1;
@@ -48,8 +54,14 @@ QPointF FrameBufferSeries::sample(size_t i) const
 QRectF FrameBufferSeries::boundingRect() const
 {
     QRectF rect;
-    auto yLim = _y->limits();
     auto xLim = _x->limits();
+
+    // Y limits are only calculated for the samples in the "rectangle of
+    // interest", so that autoscale fits the visible portion of the data
+    unsigned start = int_index_start;
+    unsigned end = std::min<unsigned>(int_index_end, _y->size() - 1);
+    Range yLim = (start <= end) ? _y->limits(start, end - start + 1) : _y->limits();
+
     rect.setBottom(yLim.start);
     rect.setTop(yLim.end);
     rect.setLeft(xLim.start);
@@ -38,6 +38,7 @@ public:
     FrameBufferSeries(const XFrameBuffer* x, const FrameBuffer* y);
 
     void setX(const XFrameBuffer* x);
+    void setY(const FrameBuffer* y);
 
     // QwtSeriesData implementations
     size_t size() const;
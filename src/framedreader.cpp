@@ -18,8 +18,9 @@
 */
 
 #include <QtDebug>
-#include <QtEndian>
-#include "floatswap.h"
+#include <algorithm>
+#include <limits>
+#include <string.h>
 
 #include "framedreader.h"
 
@@ -31,12 +32,23 @@ FramedReader::FramedReader(QIODevice* device, QObject* parent) :
     // initial settings
     settingsInvalid = 0;
     _numChannels = _settingsWidget.numOfChannels();
+    layout = _settingsWidget.frameLayout();
+    messages = _settingsWidget.messageTable();
     hasSizeByte = _settingsWidget.frameSize() == 0;
     frameSize = _settingsWidget.frameSize();
     syncWord = _settingsWidget.syncWord();
     checksumEnabled = _settingsWidget.isChecksumEnabled();
+    checksum = _settingsWidget.checksum();
+    checksumHeader = _settingsWidget.isChecksumHeaderIncluded();
     onNumberFormatChanged(_settingsWidget.numberFormat());
     debugModeEnabled = _settingsWidget.isDebugModeEnabled();
+    maxLatency = _settingsWidget.maxLatency();
+    clockChannel = _settingsWidget.clockChannel();
+    deviceClock.setClock(_settingsWidget.clockTickRate(),
+                         _settingsWidget.clockWrapBits());
+    batchSize = 0;
+    batchPackages = 0;
+    batchTimer.setSingleShot(true);
     checkSettings();
 
     // init setting connections
@@ -46,6 +58,16 @@ FramedReader::FramedReader(QIODevice* device, QObject* parent) :
     connect(&_settingsWidget, &FramedReaderSettings::numOfChannelsChanged,
             this, &FramedReader::onNumOfChannelsChanged);
 
+    connect(&_settingsWidget, &FramedReaderSettings::endiannessChanged,
+            this, &FramedReader::updateDecoder);
+    connect(&_settingsWidget, &FramedReaderSettings::fractionBitsChanged,
+            this, &FramedReader::updateDecoder);
+
+    connect(&_settingsWidget, &FramedReaderSettings::frameLayoutChanged,
+            this, &FramedReader::onFrameLayoutChanged);
+    connect(&_settingsWidget, &FramedReaderSettings::messageTableChanged,
+            this, &FramedReader::onFrameLayoutChanged);
+
     connect(&_settingsWidget, &FramedReaderSettings::syncWordChanged,
             this, &FramedReader::onSyncWordChanged);
 
@@ -55,6 +77,26 @@ FramedReader::FramedReader(QIODevice* device, QObject* parent) :
     connect(&_settingsWidget, &FramedReaderSettings::checksumChanged,
             [this](bool enabled){checksumEnabled = enabled; reset();});
 
+    connect(&_settingsWidget, &FramedReaderSettings::checksumSettingsChanged,
+            [this]()
+            {
+                checksum = _settingsWidget.checksum();
+                checksumHeader = _settingsWidget.isChecksumHeaderIncluded();
+                reset();
+            });
+
+    connect(&_settingsWidget, &FramedReaderSettings::maxLatencyChanged,
+            [this](unsigned value)
+            {
+                maxLatency = value;
+                if (value == 0) flushBatch();
+            });
+
+    connect(&_settingsWidget, &FramedReaderSettings::deviceClockChanged,
+            this, &FramedReader::onDeviceClockChanged);
+
+    connect(&batchTimer, &QTimer::timeout, this, &FramedReader::flushBatch);
+
     connect(&_settingsWidget, &FramedReaderSettings::debugModeChanged,
             [this](bool enabled){debugModeEnabled = enabled;});
 
@@ -67,50 +109,76 @@ QWidget* FramedReader::settingsWidget()
     return &_settingsWidget;
 }
 
+void FramedReader::enable(bool enabled)
+{
+    if (!enabled) flushBatch();
+    // device may have been restarted
+    if (enabled) deviceClock.reset();
+    AbstractReader::enable(enabled);
+}
+
 unsigned FramedReader::numChannels() const
 {
-    return _numChannels;
+    // clock channel is moved to X
+    return clockActive() ? _numChannels - 1 : _numChannels;
+}
+
+bool FramedReader::hasX() const
+{
+    return clockActive();
+}
+
+bool FramedReader::clockActive() const
+{
+    return clockChannel >= 0 && unsigned(clockChannel) < _numChannels && _numChannels > 1;
+}
+
+NumberFormat FramedReader::sampleFormat() const
+{
+    return _sampleFormat;
 }
 
 void FramedReader::onNumberFormatChanged(NumberFormat numberFormat)
 {
-    switch(numberFormat)
-    {
-        case NumberFormat_uint8:
-            sampleSize = 1;
-            readSample = &FramedReader::readSampleAs<quint8>;
-            break;
-        case NumberFormat_int8:
-            sampleSize = 1;
-            readSample = &FramedReader::readSampleAs<qint8>;
-            break;
-        case NumberFormat_uint16:
-            sampleSize = 2;
-            readSample = &FramedReader::readSampleAs<quint16>;
-            break;
-        case NumberFormat_int16:
-            sampleSize = 2;
-            readSample = &FramedReader::readSampleAs<qint16>;
-            break;
-        case NumberFormat_uint32:
-            sampleSize = 4;
-            readSample = &FramedReader::readSampleAs<quint32>;
-            break;
-        case NumberFormat_int32:
-            sampleSize = 4;
-            readSample = &FramedReader::readSampleAs<qint32>;
-            break;
-        case NumberFormat_float:
-            sampleSize = 4;
-            readSample = &FramedReader::readSampleAs<float>;
-            break;
-        case NumberFormat_INVALID:
-            Q_ASSERT(1); // never
-            break;
-    }
+    // layout and messages override the number format
+    if (!layout.isEmpty() || !messages.isEmpty()) return;
+
+    _sampleFormat = numberFormat;
+    updateDecoder();
 
     checkSettings();
     reset();
+    updateSampleFormat();
+}
+
+void FramedReader::updateDecoder()
+{
+    endianness = _settingsWidget.endianness();
+
+    messageDecoders.clear();
+    for (auto& message : messages.messages())
+    {
+        messageDecoders.push_back(
+            SampleDecoder(message.layout, endianness, _settingsWidget.fractionBits()));
+    }
+
+    if (!messages.isEmpty())
+    {
+        // each message has its own package size
+        packageSize = 0;
+        return;
+    }
+
+    if (layout.isEmpty())
+    {
+        decoder = SampleDecoder(_sampleFormat, endianness, _numChannels,
+                                _settingsWidget.fractionBits());
+    }
+    else
+    {
+        decoder = SampleDecoder(layout, endianness, _settingsWidget.fractionBits());
+    }
+    packageSize = decoder.packageSize();
 }
 
 void FramedReader::checkSettings()
@@ -125,8 +193,27 @@ void FramedReader::checkSettings()
         settingsInvalid &= ~SYNCWORD_INVALID;
     }
 
-    // check if fixed frame size is multiple of a sample set size
-    if (!hasSizeByte && frameSize % (_numChannels * sampleSize) != 0)
+    if (!layout.isValid())
+    {
+        settingsInvalid |= LAYOUT_INVALID;
+    }
+    else
+    {
+        settingsInvalid &= ~LAYOUT_INVALID;
+    }
+
+    if (!messages.isValid())
+    {
+        settingsInvalid |= MESSAGES_INVALID;
+    }
+    else
+    {
+        settingsInvalid &= ~MESSAGES_INVALID;
+    }
+
+    // check if fixed frame size is multiple of a sample set size,
+    // size of a message is fixed by its layout
+    if (!hasSizeByte && messages.isEmpty() && frameSize % packageSize != 0)
     {
         settingsInvalid |= FRAMESIZE_INVALID;
     }
@@ -140,11 +227,21 @@ void FramedReader::checkSettings()
     {
         _settingsWidget.showMessage("Sync word is invalid!", true);
     }
+    else if (settingsInvalid & LAYOUT_INVALID)
+    {
+        _settingsWidget.showMessage(layout.errorString(), true);
+    }
+    else if (settingsInvalid & MESSAGES_INVALID)
+    {
+        _settingsWidget.showMessage(messages.errorString(), true);
+    }
     else if (settingsInvalid & FRAMESIZE_INVALID)
     {
         QString errorMessage =
-            QString("Frame size must be multiple of %1 (#channels * sample size)!")\
-            .arg(_numChannels * sampleSize);
+            QString(layout.isEmpty() ?
+                    "Frame size must be multiple of %1 (#channels * sample size)!" :
+                    "Frame size must be multiple of %1 (layout size)!")\
+            .arg(packageSize);
 
         _settingsWidget.showMessage(errorMessage, true);
     }
@@ -156,11 +253,55 @@ void FramedReader::checkSettings()
 
 void FramedReader::onNumOfChannelsChanged(unsigned value)
 {
+    // layout and messages override the number of channels
+    if (!layout.isEmpty() || !messages.isEmpty()) return;
+
     _numChannels = value;
+    updateDecoder();
     checkSettings();
     reset();
     updateNumChannels();
-    emit numOfChannelsChanged(value);
+    emit numOfChannelsChanged(numChannels());
+}
+
+void FramedReader::onFrameLayoutChanged()
+{
+    layout = _settingsWidget.frameLayout();
+    messages = _settingsWidget.messageTable();
+    if (!messages.isEmpty())
+    {
+        _numChannels = messages.numChannels();
+        // messages may have different types
+        _sampleFormat = NumberFormat_INVALID;
+    }
+    else if (layout.isEmpty())
+    {
+        _numChannels = _settingsWidget.numOfChannels();
+        _sampleFormat = _settingsWidget.numberFormat();
+    }
+    else
+    {
+        _numChannels = layout.numChannels();
+        // there is no common type, samples are stored as double
+        _sampleFormat = NumberFormat_INVALID;
+    }
+
+    updateDecoder();
+    checkSettings();
+    reset();
+    updateNumChannels();
+    updateSampleFormat();
+    emit numOfChannelsChanged(numChannels());
+}
+
+void FramedReader::onDeviceClockChanged()
+{
+    flushBatch();
+    clockChannel = _settingsWidget.clockChannel();
+    deviceClock.setClock(_settingsWidget.clockTickRate(),
+                         _settingsWidget.clockWrapBits());
+    updateNumChannels();
+    emit numOfChannelsChanged(numChannels());
 }
 
 void FramedReader::onSyncWordChanged(QByteArray word)
@@ -187,150 +328,253 @@ void FramedReader::onFrameSizeChanged(unsigned value)
 
 unsigned FramedReader::readData()
 {
-    unsigned numBytesRead = 0;
-
-    if (settingsInvalid) return numBytesRead;
-
-    // loop until we run out of bytes or more bytes is required
-    unsigned bytesAvailable;
-    while ((bytesAvailable = _device->bytesAvailable()))
+    if (settingsInvalid) return 0;
+
+    // append all available bytes to the window
+    unsigned oldSize = window.size();
+    qint64 available = _device->bytesAvailable();
+    window.resize(oldSize + available);
+    qint64 numRead = _device->read(window.data() + oldSize, available);
+    if (numRead < 0) numRead = 0;
+    window.resize(oldSize + numRead);
+
+    // parse as many frames as window holds
+    const char* data = window.constData();
+    const unsigned size = window.size();
+    const unsigned syncSize = syncWord.size();
+    const unsigned checksumSize = checksumEnabled ? checksum.size() : 0;
+    unsigned pos = 0;           // start of unparsed bytes
+    while (pos < size)
     {
-        if (!gotSync) // read sync word
+        unsigned syncPos = findSyncWord(pos);
+        if (debugModeEnabled && syncPos > pos)
         {
-            char c;
-            _device->getChar(&c);
-            numBytesRead++;
-            if (c == syncWord[sync_i]) // correct sync byte?
+            qCritical() << "Skipped" << syncPos - pos << "bytes searching for sync word.";
+        }
+        pos = syncPos;
+        if (syncPos + syncSize > size) break; // no (complete) sync word
+
+        unsigned i = syncPos + syncSize;
+        unsigned payloadSize = frameSize;
+        unsigned pkgSize = packageSize;
+        int message = 0;
+        if (!messages.isEmpty())
+        {
+            if (i >= size) break; // wait for message ID
+            message = messages.indexOf(data[i++]);
+            if (message < 0)
             {
-                sync_i++;
-                if (sync_i == (unsigned) syncWord.length())
+                if (debugModeEnabled)
                 {
-                    gotSync = true;
+                    qCritical() << "Unknown message ID:" << (unsigned char) data[i-1];
                 }
+                pos++;
+                continue;
             }
-            else
-            {
-                if (debugModeEnabled) qCritical() << "Missed " << sync_i+1 << "th sync byte.";
-            }
+            // without size byte payload is a single package
+            pkgSize = messageDecoders[message].packageSize();
+            payloadSize = pkgSize;
         }
-        else if (hasSizeByte && !gotSize) // skipped if fixed frame size
+
+        if (hasSizeByte)
         {
-            frameSize = 0;
-            _device->getChar((char*) &frameSize);
-            numBytesRead++;
+            if (i >= size) break; // wait for size byte
+            payloadSize = (unsigned char) data[i++];
 
-            if (frameSize == 0) // check size
+            if (payloadSize == 0) // check size
             {
                 qCritical() << "Frame size is 0!";
-                reset();
+                pos++;      // look for next sync word
+                continue;
             }
-            else if (frameSize % (_numChannels * sampleSize) != 0)
+            else if (payloadSize % pkgSize != 0)
             {
                 qCritical() <<
-                    QString("Frame size is not multiple of %1 (#channels * sample size)!") \
-                    .arg(_numChannels * sampleSize);
-                reset();
+                    QString("Frame size is not multiple of %1 (package size)!") \
+                    .arg(pkgSize);
+                pos++;
+                continue;
             }
-            else
+            else if (debugModeEnabled)
             {
-                if (debugModeEnabled) qDebug() << "Frame size:" << frameSize;
-                gotSize = true;
-            }
-        }
-        else // read data bytes
-        {
-            // have enough data bytes? (+1 for checksum)
-            if (bytesAvailable < (checksumEnabled ? frameSize+1 : frameSize))
-            {
-                break;
-            }
-            else // read data bytes and checksum
-            {
-                readFrameDataAndCheck();
-                numBytesRead += checksumEnabled ? frameSize+1 : frameSize;
-                reset();
+                qDebug() << "Frame size:" << payloadSize;
             }
         }
+
+        if (i + payloadSize + checksumSize > size) break; // wait for rest of the frame
+
+        readFrame(data + syncPos, data + i, payloadSize, message);
+        pos = i + payloadSize + checksumSize;
+    }
+
+    // keep the unparsed part
+    window.remove(0, pos);
+
+    // commit frames now or when latency budget expires
+    if (maxLatency == 0)
+    {
+        flushBatch();
+    }
+    else if (batchPackages && !batchTimer.isActive())
+    {
+        batchTimer.start(maxLatency);
     }
 
-    return numBytesRead;
+    return numRead;
+}
+
+unsigned FramedReader::findSyncWord(unsigned start) const
+{
+    const char* data = window.constData();
+    const unsigned size = window.size();
+    const unsigned syncSize = syncWord.size();
+
+    // find candidates with (vectorized) `memchr`, then compare the rest
+    unsigned i = start;
+    while (i < size)
+    {
+        auto p = static_cast<const char*>(memchr(data + i, syncWord[0], size - i));
+        if (p == nullptr) return size;
+
+        i = p - data;
+        unsigned n = std::min(syncSize, size - i); // may be cut at the end
+        if (memcmp(p, syncWord.constData(), n) == 0) return i;
+        i++;
+    }
+    return size;
 }
 
 void FramedReader::reset()
 {
-    sync_i = 0;
-    gotSync = false;
-    gotSize = false;
-    if (hasSizeByte) frameSize = 0;
-    calcChecksum = 0;
+    window.clear();
+
+    // held frames may not match the new settings
+    batchTimer.stop();
+    batchSize = 0;
+    batchPackages = 0;
+    batchFrames.clear();
+    deviceClock.reset();
+
+    // nothing is received yet
+    lastValues.assign(_numChannels, std::numeric_limits<double>::quiet_NaN());
 }
 
-// Important: this function assumes device has enough bytes to read a full frames data and checksum
-void FramedReader::readFrameDataAndCheck()
+void FramedReader::readFrame(const char* header, const char* payload, unsigned size,
+                             unsigned message)
 {
-    // if paused just read and waste data
-    if (paused)
-    {
-        _device->read(checksumEnabled ? frameSize+1 : frameSize);
-        return;
-    }
+    // if paused just waste data
+    if (paused) return;
 
-    // a package is 1 set of samples for all channels
-    unsigned numOfPackagesToRead = frameSize / (_numChannels * sampleSize);
-    SamplePack samples(numOfPackagesToRead, _numChannels);
-    for (unsigned i = 0; i < numOfPackagesToRead; i++)
+    // check checksum
+    if (checksumEnabled)
     {
-        for (unsigned int ci = 0; ci < _numChannels; ci++)
+        const char* start = checksumHeader ? header : payload;
+        quint32 calcChecksum = checksum.calculate(start, payload + size - start);
+        quint32 rChecksum = readChecksum(payload + size);
+        if (calcChecksum != rChecksum)
         {
-            samples.data(ci)[i] = (this->*readSample)();
+            qCritical() << "Checksum failed! Received:" << rChecksum << "Calculated:" << calcChecksum;
+            return;
         }
     }
 
-    // read checksum
-    unsigned rChecksum = 0;
-    bool checksumPassed = false;
-    if (checksumEnabled)
+    // append to batch, buffer isn't shrunk to avoid re-allocations
+    if ((unsigned) batch.size() < batchSize + size)
     {
-        _device->read((char*) &rChecksum, 1);
-        calcChecksum &= 0xFF;
-        checksumPassed = (calcChecksum == rChecksum);
+        batch.resize(batchSize + size);
     }
-
-    if (!checksumEnabled || checksumPassed)
+    memcpy(batch.data() + batchSize, payload, size);
+    batchSize += size;
+    // a package is 1 set of samples for all channels
+    if (messages.isEmpty())
     {
-        // commit data
-        feedOut(samples);
+        batchPackages += size / packageSize;
     }
     else
     {
-        qCritical() << "Checksum failed! Received:" << rChecksum << "Calculated:" << calcChecksum;
+        unsigned n = size / messageDecoders[message].packageSize();
+        batchFrames.push_back({message, n});
+        batchPackages += n;
     }
 }
 
-template<typename T> double FramedReader::readSampleAs()
+void FramedReader::flushBatch()
 {
-    T data;
-
-    _device->read((char*) &data, sizeof(data));
-
-    if (checksumEnabled)
+    batchTimer.stop();
+    if (!batchPackages) return;
+
+    // messages don't have bit packed formats
+    unsigned numSamples = messages.isEmpty() ?
+        batchPackages * decoder.packageSamples() : batchPackages;
+    SamplePack samples = packPool.take(numSamples, _numChannels);
+    if (messages.isEmpty())
     {
-        for (unsigned i = 0; i < sizeof(data); i++)
-        {
-            calcChecksum += ((unsigned char*) &data)[i];
-        }
+        decoder.decode(batch.constData(), batchPackages, samples, 0);
     }
-
-    if (_settingsWidget.endianness() == LittleEndian)
+    else
     {
-        data = qFromLittleEndian(data);
+        decodeMessages(samples);
+    }
+    batchSize = 0;
+    batchPackages = 0;
+    batchFrames.clear();
+    stamp(samples);
+    if (clockActive())
+    {
+        SamplePack timed = packPool.take(samples.numSamples(), _numChannels - 1, true);
+        deviceClock.apply(samples, clockChannel, timed);
+        feedOut(timed);
+        packPool.recycle(std::move(timed));
     }
     else
     {
-        data = qFromBigEndian(data);
+        feedOut(samples);
     }
+    packPool.recycle(std::move(samples));
+}
 
-    return double(data);
+void FramedReader::decodeMessages(SamplePack& samples)
+{
+    const char* src = batch.constData();
+    unsigned start = 0;
+    for (auto& frame : batchFrames)
+    {
+        const auto& message = messages.messages()[frame.message];
+        const SampleDecoder& dec = messageDecoders[frame.message];
+        const unsigned n = frame.numPackages;
+        const unsigned first = message.firstChannel;
+        const unsigned last = first + message.layout.numChannels();
+
+        // other messages' channels repeat their last values
+        for (unsigned ci = 0; ci < _numChannels; ci++)
+        {
+            if (ci >= first && ci < last) continue;
+            double* d = samples.data(ci) + start;
+            std::fill(d, d + n, lastValues[ci]);
+        }
+
+        dec.decodeGroup(src, n, samples, start, first);
+        for (unsigned ci = first; ci < last; ci++)
+        {
+            lastValues[ci] = samples.data(ci)[start + n - 1];
+        }
+
+        src += n * dec.packageSize();
+        start += n;
+    }
+}
+
+quint32 FramedReader::readChecksum(const char* data) const
+{
+    auto bytes = reinterpret_cast<const uchar*>(data);
+    unsigned n = checksum.size();
+    quint32 value = 0;
+    for (unsigned i = 0; i < n; i++)
+    {
+        unsigned b = endianness == LittleEndian ? n - 1 - i : i;
+        value = (value << 8) | bytes[b];
+    }
+    return value;
 }
 
 void FramedReader::saveSettings(QSettings* settings)
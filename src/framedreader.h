@@ -21,9 +21,12 @@
 #define FRAMEDREADER_H
 
 #include <QSettings>
+#include <vector>
 
 #include "abstractreader.h"
 #include "framedreadersettings.h"
+#include "sampledecoder.h"
+#include "deviceclock.h"
 
 /**
  * Reads data in a customizable framed format.
@@ -35,7 +38,12 @@ class FramedReader : public AbstractReader
 public:
     explicit FramedReader(QIODevice* device, QObject *parent = 0);
     QWidget* settingsWidget();
+    /// Commits held frames before disabling, resets the device clock when enabling
+    void enable(bool enabled = true) override;
     unsigned numChannels() const;
+    /// Provides X data when a device clock channel is selected
+    bool hasX() const override;
+    NumberFormat sampleFormat() const override;
     /// Stores settings into a `QSettings`
     void saveSettings(QSettings* settings);
     /// Loads settings from a `QSettings`.
@@ -46,19 +54,33 @@ private:
     enum SettingInvalidFlag
     {
         SYNCWORD_INVALID = 1,
-        FRAMESIZE_INVALID = 2
+        FRAMESIZE_INVALID = 2,
+        LAYOUT_INVALID = 4,
+        MESSAGES_INVALID = 8
     };
 
     // settings related members
     FramedReaderSettings _settingsWidget;
     unsigned _numChannels;
-    unsigned sampleSize;
+    NumberFormat _sampleFormat;
+    unsigned packageSize;       ///< size of a sample set (1 sample for each channel), `0` with messages
+    FrameLayout layout;         ///< mixed type layout, samples are uniform if empty
+    MessageTable messages;      ///< frame types, overrides `layout` if not empty
     unsigned settingsInvalid;   /// settings are all valid if this is 0, if not no reading is done
     QByteArray syncWord;
     bool checksumEnabled;
+    Checksum checksum;          ///< selected checksum and its parameters
+    bool checksumHeader;        ///< checksum covers sync word and size byte
+    Endianness endianness;      ///< byte order of samples and checksum
     bool hasSizeByte;
     unsigned frameSize;
     bool debugModeEnabled;
+    unsigned maxLatency;        ///< ms, `0` means commit at the end of each read
+    int clockChannel;           ///< index of the device clock channel, `-1` if none
+    DeviceClock deviceClock;    ///< maps the clock channel to X data
+
+    /// Returns true if the selected clock channel exists
+    bool clockActive() const;
 
     /// Checks the validity of syncWord and frameSize then shows an
     /// error message. Also updates `settingsInvalid`. If settings are
@@ -66,18 +88,53 @@ private:
     void checkSettings();
 
     // read state related members
-    unsigned sync_i; /// sync byte index to be read next
-    bool gotSync;    /// indicates if sync word is captured
-    bool gotSize;    /// indicates if size is captured, ignored if size byte is disabled (fixed size)
-    unsigned calcChecksum;
-
-    void reset();    /// Resets the reading state. Used in case of error or setting change.
-    /// points to the readSampleAs function for currently selected number format
-    double (FramedReader::*readSample)();
-    template<typename T> double readSampleAs();
-    /// reads payload portion of the frame, calculates checksum and commits data
-    /// @note should be called only if there are enough bytes on device
-    void readFrameDataAndCheck();
+    /// Bytes read from device but not parsed yet. Starts with an
+    /// incomplete frame (or part of sync word) after a read.
+    QByteArray window;
+
+    /// Payloads of verified frames that are waiting to be committed
+    /// together. Since all frames have the same layout they can be
+    /// decoded as a single block, unless there are multiple message
+    /// types (see `batchFrames`).
+    QByteArray batch;
+    unsigned batchSize;         ///< number of used bytes in `batch`
+    unsigned batchPackages;     ///< number of packages in `batch`
+    /// Started with the first held frame, batch is committed at timeout
+    QTimer batchTimer;
+
+    /// A frame in the `batch` when there are multiple message types
+    struct BatchFrame
+    {
+        unsigned message;       ///< index in `messages`
+        unsigned numPackages;
+    };
+    std::vector<BatchFrame> batchFrames;
+    /// Last received value of each channel, repeated by the frames
+    /// of other messages
+    std::vector<double> lastValues;
+
+    void reset();    /// Resets the reading state. Used in case of setting change.
+    /// decodes samples in currently selected format
+    SampleDecoder decoder;
+    /// one decoder for each message, same order as `messages`
+    std::vector<SampleDecoder> messageDecoders;
+
+    /// Returns the index of first sync word in `window` at or after
+    /// `start`. If there is none, returns the index of a partial sync
+    /// word at the end of the window or size of the window.
+    unsigned findSyncWord(unsigned start) const;
+    /// Decodes the payload of a frame, verifies checksum and commits data
+    /// @param header start of the frame (sync word)
+    /// @param payload start of payload, followed by checksum if it's enabled
+    /// @param size payload size
+    /// @param message index of the message type, `0` if there is no message table
+    /// @note verified payload is added to the `batch`, it's not committed
+    void readFrame(const char* header, const char* payload, unsigned size,
+                   unsigned message);
+    /// Decodes the `batch` of different message types into `samples`
+    void decodeMessages(SamplePack& samples);
+    /// Reads the received checksum value at `data` in frame byte order
+    quint32 readChecksum(const char* data) const;
 
     unsigned readData() override;
 
@@ -85,8 +142,16 @@ private slots:
 
     void onNumberFormatChanged(NumberFormat numberFormat);
     void onNumOfChannelsChanged(unsigned value);
+    /// Re-creates the `decoder` for current settings
+    void updateDecoder();
     void onSyncWordChanged(QByteArray);
     void onFrameSizeChanged(unsigned);
+    /// Applies the layout and message table settings
+    void onFrameLayoutChanged();
+    /// Re-creates the `deviceClock` for current settings
+    void onDeviceClockChanged();
+    /// Decodes and commits all frames in the `batch` as a single pack
+    void flushBatch();
 };
 
 #endif // FRAMEDREADER_H
@@ -18,6 +18,7 @@
 */
 
 #include <QButtonGroup>
+#include <QRegularExpressionValidator>
 
 #include "utils.h"
 #include "defines.h"
@@ -35,12 +36,45 @@ FramedReaderSettings::FramedReaderSettings(QWidget *parent) :
     ui->leSyncWord->setText("AA BB");
     ui->spNumOfChannels->setMaximum(MAX_NUM_CHANNELS);
 
+    // fill checksum types, item data is `ChecksumType`
+    ui->cbChecksumType->addItem("Sum (8 bit)", ChecksumType_Sum8);
+    ui->cbChecksumType->addItem("CRC-8", ChecksumType_CRC8);
+    ui->cbChecksumType->addItem("CRC-16/CCITT", ChecksumType_CRC16_CCITT);
+    ui->cbChecksumType->addItem("CRC-16/Modbus", ChecksumType_CRC16_Modbus);
+    ui->cbChecksumType->addItem("CRC-32", ChecksumType_CRC32);
+    onChecksumTypeSelected(0);
+
+    auto hexValidator = new QRegularExpressionValidator(
+        QRegularExpression("[0-9A-Fa-f]{1,8}"), this);
+    ui->leChecksumInit->setValidator(hexValidator);
+    ui->leChecksumXorOut->setValidator(hexValidator);
+
     connect(ui->cbChecksum, &QCheckBox::toggled,
             [this](bool enabled)
             {
+                ui->cbChecksumType->setEnabled(enabled);
+                ui->cbChecksumHeader->setEnabled(enabled);
+                ui->leChecksumInit->setEnabled(enabled);
+                ui->leChecksumXorOut->setEnabled(enabled);
+                ui->cbChecksumReflect->setEnabled(enabled);
                 emit checksumChanged(enabled);
             });
 
+    connect(ui->cbChecksumType, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged),
+            this, &FramedReaderSettings::onChecksumTypeSelected);
+
+    connect(ui->leChecksumInit, &QLineEdit::textChanged,
+            this, &FramedReaderSettings::checksumSettingsChanged);
+
+    connect(ui->leChecksumXorOut, &QLineEdit::textChanged,
+            this, &FramedReaderSettings::checksumSettingsChanged);
+
+    connect(ui->cbChecksumReflect, &QCheckBox::toggled,
+            this, &FramedReaderSettings::checksumSettingsChanged);
+
+    connect(ui->cbChecksumHeader, &QCheckBox::toggled,
+            this, &FramedReaderSettings::checksumSettingsChanged);
+
     connect(ui->cbDebugMode, &QCheckBox::toggled,
             this, &FramedReaderSettings::debugModeChanged);
 
@@ -66,12 +100,43 @@ FramedReaderSettings::FramedReaderSettings(QWidget *parent) :
                 emit numOfChannelsChanged(value);
             });
 
+    connect(ui->spMaxLatency, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
+            [this](int value)
+            {
+                emit maxLatencyChanged(value);
+            });
+
+    connect(ui->clockBox, &DeviceClockBox::changed,
+            this, &FramedReaderSettings::deviceClockChanged);
+
     connect(ui->leSyncWord, &QLineEdit::textChanged,
             this, &FramedReaderSettings::onSyncWordEdited);
 
     connect(ui->nfBox, SIGNAL(selectionChanged(NumberFormat)),
             this, SIGNAL(numberFormatChanged(NumberFormat)));
 
+    connect(ui->endiBox, SIGNAL(selectionChanged(Endianness)),
+            this, SIGNAL(endiannessChanged(Endianness)));
+
+    connect(ui->nfBox, SIGNAL(fractionBitsChanged(unsigned)),
+            this, SIGNAL(fractionBitsChanged(unsigned)));
+
+    // layout replaces the number of channels and number type
+    connect(ui->leLayout, &QLineEdit::textChanged,
+            [this](QString)
+            {
+                updateFormatEnabled();
+                emit frameLayoutChanged();
+            });
+
+    // message table replaces the layout too
+    connect(ui->leMessages, &QLineEdit::textChanged,
+            [this](QString)
+            {
+                updateFormatEnabled();
+                emit messageTableChanged();
+            });
+
     // add frame size selection buttons to same group
     QButtonGroup* group = new QButtonGroup(this);
     group->addButton(ui->rbFixedSize);
@@ -111,6 +176,30 @@ Endianness FramedReaderSettings::endianness()
     return ui->endiBox->currentSelection();
 }
 
+unsigned FramedReaderSettings::fractionBits()
+{
+    return ui->nfBox->fractionBits();
+}
+
+FrameLayout FramedReaderSettings::frameLayout()
+{
+    return FrameLayout(ui->leLayout->text());
+}
+
+MessageTable FramedReaderSettings::messageTable()
+{
+    return MessageTable(ui->leMessages->text());
+}
+
+void FramedReaderSettings::updateFormatEnabled()
+{
+    bool hasMessages = !ui->leMessages->text().trimmed().isEmpty();
+    bool uniform = !hasMessages && ui->leLayout->text().trimmed().isEmpty();
+    ui->spNumOfChannels->setEnabled(uniform);
+    ui->nfBox->setEnabled(uniform);
+    ui->leLayout->setEnabled(!hasMessages);
+}
+
 QByteArray FramedReaderSettings::syncWord()
 {
     QString text = ui->leSyncWord->text().remove(' ');
@@ -149,6 +238,57 @@ bool FramedReaderSettings::isChecksumEnabled()
     return ui->cbChecksum->isChecked();
 }
 
+Checksum FramedReaderSettings::checksum()
+{
+    auto type = (ChecksumType) ui->cbChecksumType->currentData().toInt();
+    return Checksum(type,
+                    ui->leChecksumInit->text().toUInt(nullptr, 16),
+                    ui->leChecksumXorOut->text().toUInt(nullptr, 16),
+                    ui->cbChecksumReflect->isChecked());
+}
+
+bool FramedReaderSettings::isChecksumHeaderIncluded()
+{
+    return ui->cbChecksumHeader->isChecked();
+}
+
+void FramedReaderSettings::onChecksumTypeSelected(int index)
+{
+    // reset parameters to the standard values of selected type
+    auto preset = Checksum::preset((ChecksumType) ui->cbChecksumType->itemData(index).toInt());
+    setChecksumParams(preset.type(), preset.init(), preset.xorOut(), preset.reflect());
+    emit checksumSettingsChanged();
+}
+
+void FramedReaderSettings::setChecksumParams(ChecksumType type, quint32 init,
+                                             quint32 xorOut, bool reflect)
+{
+    int numDigits = Checksum(type).size() * 2;
+    ui->leChecksumInit->setText(QString("%1").arg(init, numDigits, 16, QChar('0')).toUpper());
+    ui->leChecksumXorOut->setText(QString("%1").arg(xorOut, numDigits, 16, QChar('0')).toUpper());
+    ui->cbChecksumReflect->setChecked(reflect);
+}
+
+unsigned FramedReaderSettings::maxLatency()
+{
+    return ui->spMaxLatency->value();
+}
+
+int FramedReaderSettings::clockChannel()
+{
+    return ui->clockBox->channel();
+}
+
+double FramedReaderSettings::clockTickRate()
+{
+    return ui->clockBox->tickRate();
+}
+
+unsigned FramedReaderSettings::clockWrapBits()
+{
+    return ui->clockBox->wrapBits();
+}
+
 bool FramedReaderSettings::isDebugModeEnabled()
 {
     return ui->cbDebugMode->isChecked();
@@ -161,10 +301,23 @@ void FramedReaderSettings::saveSettings(QSettings* settings)
     settings->setValue(SG_CustomFrame_NumberFormat, numberFormatToStr(numberFormat()));
     settings->setValue(SG_CustomFrame_Endianness,
                        endianness() == LittleEndian ? "little" : "big");
+    settings->setValue(SG_CustomFrame_FractionBits, fractionBits());
+    settings->setValue(SG_CustomFrame_Layout, ui->leLayout->text());
+    settings->setValue(SG_CustomFrame_Messages, ui->leMessages->text());
     settings->setValue(SG_CustomFrame_FrameStart, ui->leSyncWord->text());
     settings->setValue(SG_CustomFrame_FixedSize, ui->rbFixedSize->isChecked());
     settings->setValue(SG_CustomFrame_FrameSize, ui->spSize->value());
     settings->setValue(SG_CustomFrame_Checksum, ui->cbChecksum->isChecked());
+    settings->setValue(SG_CustomFrame_ChecksumType,
+                       checksumTypeToStr(checksum().type()));
+    settings->setValue(SG_CustomFrame_ChecksumInit, ui->leChecksumInit->text());
+    settings->setValue(SG_CustomFrame_ChecksumXorOut, ui->leChecksumXorOut->text());
+    settings->setValue(SG_CustomFrame_ChecksumReflect, ui->cbChecksumReflect->isChecked());
+    settings->setValue(SG_CustomFrame_ChecksumHeader, ui->cbChecksumHeader->isChecked());
+    settings->setValue(SG_CustomFrame_MaxLatency, maxLatency());
+    settings->setValue(SG_CustomFrame_ClockChannel, clockChannel());
+    settings->setValue(SG_CustomFrame_ClockTickRate, clockTickRate());
+    settings->setValue(SG_CustomFrame_ClockWrapBits, clockWrapBits());
     settings->setValue(SG_CustomFrame_DebugMode, ui->cbDebugMode->isChecked());
     settings->endGroup();
 }
@@ -196,6 +349,18 @@ void FramedReaderSettings::loadSettings(QSettings* settings)
         ui->endiBox->setSelection(BigEndian);
     } // else don't change
 
+    // load fraction bits
+    ui->nfBox->setFractionBits(
+        settings->value(SG_CustomFrame_FractionBits, fractionBits()).toUInt());
+
+    // load layout
+    ui->leLayout->setText(
+        settings->value(SG_CustomFrame_Layout, ui->leLayout->text()).toString());
+
+    // load message table
+    ui->leMessages->setText(
+        settings->value(SG_CustomFrame_Messages, ui->leMessages->text()).toString());
+
     // load frame start
     QString frameStartSetting =
         settings->value(SG_CustomFrame_FrameStart, ui->leSyncWord->text()).toString();
@@ -217,6 +382,41 @@ void FramedReaderSettings::loadSettings(QSettings* settings)
     ui->cbChecksum->setChecked(
         settings->value(SG_CustomFrame_Checksum, ui->cbChecksum->isChecked()).toBool());
 
+    // load checksum type and parameters, type should be loaded first
+    // as it resets parameters
+    ChecksumType ctSetting =
+        strToChecksumType(settings->value(SG_CustomFrame_ChecksumType,
+                                          QString()).toString());
+    if (ctSetting != ChecksumType_INVALID)
+    {
+        ui->cbChecksumType->setCurrentIndex(ui->cbChecksumType->findData(ctSetting));
+    }
+    Checksum cs = checksum();
+    bool ok;
+    quint32 initSetting =
+        settings->value(SG_CustomFrame_ChecksumInit, QString()).toString().toUInt(&ok, 16);
+    if (!ok) initSetting = cs.init();
+    quint32 xorOutSetting =
+        settings->value(SG_CustomFrame_ChecksumXorOut, QString()).toString().toUInt(&ok, 16);
+    if (!ok) xorOutSetting = cs.xorOut();
+    bool reflectSetting =
+        settings->value(SG_CustomFrame_ChecksumReflect, cs.reflect()).toBool();
+    setChecksumParams(cs.type(), initSetting, xorOutSetting, reflectSetting);
+    ui->cbChecksumHeader->setChecked(
+        settings->value(SG_CustomFrame_ChecksumHeader, ui->cbChecksumHeader->isChecked()).toBool());
+
+    // load max latency
+    ui->spMaxLatency->setValue(
+        settings->value(SG_CustomFrame_MaxLatency, maxLatency()).toInt());
+
+    // load device clock
+    ui->clockBox->setTickRate(
+        settings->value(SG_CustomFrame_ClockTickRate, clockTickRate()).toDouble());
+    ui->clockBox->setWrapBits(
+        settings->value(SG_CustomFrame_ClockWrapBits, clockWrapBits()).toUInt());
+    ui->clockBox->setChannel(
+        settings->value(SG_CustomFrame_ClockChannel, clockChannel()).toInt());
+
     // load debug mode
     ui->cbDebugMode->setChecked(
         settings->value(SG_CustomFrame_DebugMode, ui->cbDebugMode->isChecked()).toBool());
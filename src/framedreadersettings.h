@@ -26,6 +26,10 @@
 
 #include "numberformatbox.h"
 #include "endiannessbox.h"
+#include "deviceclockbox.h"
+#include "checksum.h"
+#include "framelayout.h"
+#include "messagetable.h"
 
 namespace Ui {
 class FramedReaderSettings;
@@ -44,9 +48,27 @@ public:
     unsigned numOfChannels();
     NumberFormat numberFormat();
     Endianness endianness();
+    /// Number of fraction bits for fixed point number formats
+    unsigned fractionBits();
+    /// Mixed type layout of samples, empty if not set
+    FrameLayout frameLayout();
+    /// Frame types selected by message ID, empty if not set
+    MessageTable messageTable();
     QByteArray syncWord();
     unsigned frameSize(); /// If frame bye is enabled `0` is returned
     bool isChecksumEnabled();
+    /// Returns the selected checksum with its parameters
+    Checksum checksum();
+    /// Whether checksum is calculated over the header (sync word and size byte) too
+    bool isChecksumHeaderIncluded();
+    /// Maximum duration (ms) frames can be held for batching
+    unsigned maxLatency();
+    /// Index of the device clock channel, `-1` if none
+    int clockChannel();
+    /// Nominal tick rate of the device clock in Hz
+    double clockTickRate();
+    /// Device clock counter width in bits, `0` if it doesn't wrap
+    unsigned clockWrapBits();
     bool isDebugModeEnabled();
     /// Save settings into a `QSettings`
     void saveSettings(QSettings* settings);
@@ -60,15 +82,30 @@ signals:
     /// `0` indicates frame size byte is enabled
     void frameSizeChanged(unsigned);
     void checksumChanged(bool);
+    /// Emitted when checksum type, its parameters or header coverage changes
+    void checksumSettingsChanged();
     void numOfChannelsChanged(unsigned);
     void numberFormatChanged(NumberFormat);
+    void endiannessChanged(Endianness);
+    void fractionBitsChanged(unsigned);
+    void frameLayoutChanged();
+    void messageTableChanged();
+    void maxLatencyChanged(unsigned);
+    void deviceClockChanged();
     void debugModeChanged(bool);
 
 private:
     Ui::FramedReaderSettings *ui;
 
+    /// Shows checksum parameters in hexadecimal with width of `type`
+    void setChecksumParams(ChecksumType type, quint32 init, quint32 xorOut, bool reflect);
+    /// Enables number of channels, number type and layout inputs
+    /// depending on which one is overridden
+    void updateFormatEnabled();
+
 private slots:
     void onSyncWordEdited();
+    void onChecksumTypeSelected(int index);
 };
 
 #endif // FRAMEDREADERSETTINGS_H
@@ -0,0 +1,248 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QStringList>
+
+#include "framelayout.h"
+#include "sampledecoder.h"
+#include "defines.h"
+
+/// Upper limit for offsets and repeat counts, also limits the package size
+static const unsigned MAX_LAYOUT_SIZE = 65536;
+
+FrameLayout::FrameLayout()
+{
+    _size = 0;
+}
+
+FrameLayout::FrameLayout(QString text)
+{
+    _size = 0;
+    if (text.trimmed().isEmpty()) return;
+
+    unsigned offset = 0;
+    for (auto item : text.split(','))
+    {
+        if (!parseItem(item.trimmed(), offset))
+        {
+            _fields.clear();
+            _size = 0;
+            return;
+        }
+    }
+
+    if (_fields.isEmpty())
+    {
+        _error = "Layout has no channels!";
+    }
+    else if ((unsigned) _fields.size() > MAX_NUM_CHANNELS)
+    {
+        _error = QString("Layout has more than %1 channels!").arg(MAX_NUM_CHANNELS);
+    }
+    else
+    {
+        return;
+    }
+    _fields.clear();
+    _size = 0;
+}
+
+bool FrameLayout::parseItem(QString item, unsigned& offset)
+{
+    bool ok = true;
+
+    // offset, if it's specified
+    int at = item.indexOf('@');
+    if (at >= 0)
+    {
+        offset = item.mid(at + 1).trimmed().toUInt(&ok, 0);
+        if (!ok || offset >= MAX_LAYOUT_SIZE)
+        {
+            _error = QString("Invalid offset in \"%1\"!").arg(item);
+            return false;
+        }
+        item = item.left(at).trimmed();
+    }
+
+    // byte order
+    Field field;
+    field.defaultEndianness = true;
+    field.endianness = LittleEndian;
+    field.bitShift = 0;
+    field.bitWidth = 0;
+    field.bitSigned = false;
+    int colon = item.indexOf(':');
+    if (colon >= 0)
+    {
+        QString order = item.mid(colon + 1).trimmed();
+        if (order == "le")
+        {
+            field.endianness = LittleEndian;
+        }
+        else if (order == "be")
+        {
+            field.endianness = BigEndian;
+        }
+        else
+        {
+            _error = QString("Invalid byte order \"%1\", must be \"le\" or \"be\"!").arg(order);
+            return false;
+        }
+        field.defaultEndianness = false;
+        item = item.left(colon).trimmed();
+    }
+
+    // repeat count
+    unsigned count = 1;
+    int star = item.indexOf('*');
+    if (star >= 0)
+    {
+        count = item.left(star).trimmed().toUInt(&ok);
+        if (!ok || count == 0 || count > MAX_LAYOUT_SIZE)
+        {
+            _error = QString("Invalid count in \"%1\"!").arg(item);
+            return false;
+        }
+        item = item.mid(star + 1).trimmed();
+    }
+
+    // bit fields
+    QString bits;
+    int brace = item.indexOf('{');
+    if (brace >= 0)
+    {
+        if (!item.endsWith('}'))
+        {
+            _error = QString("Missing '}' in \"%1\"!").arg(item);
+            return false;
+        }
+        bits = item.mid(brace + 1, item.size() - brace - 2);
+        item = item.left(brace).trimmed();
+    }
+
+    // type
+    unsigned size;
+    bool pad = item == "pad";
+    QVector<Field> parts;       // channels of a single repeat
+    if (pad)
+    {
+        size = 1;
+        if (brace >= 0)
+        {
+            _error = "Padding can't have bit fields!";
+            return false;
+        }
+    }
+    else
+    {
+        field.format = strToNumberFormat(item);
+        if (field.format == NumberFormat_INVALID)
+        {
+            _error = QString("Unknown type \"%1\"!").arg(item);
+            return false;
+        }
+        if (sampleBits(field.format) % 8)
+        {
+            _error = QString("Bit packed type \"%1\" can't be used in a layout!").arg(item);
+            return false;
+        }
+        size = sampleSize(field.format);
+
+        if (brace < 0)
+        {
+            parts.append(field);
+        }
+        else if (!parseBitFields(bits, field, parts))
+        {
+            return false;
+        }
+    }
+
+    if (offset + count * size > MAX_LAYOUT_SIZE)
+    {
+        _error = "Layout is too big!";
+        return false;
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        for (auto part : parts)
+        {
+            part.offset = offset;
+            _fields.append(part);
+        }
+        offset += size;
+    }
+    if (offset > _size) _size = offset;
+
+    return true;
+}
+
+bool FrameLayout::parseBitFields(QString bits, const Field& field, QVector<Field>& parts)
+{
+    switch (field.format)
+    {
+        case NumberFormat_uint8:
+        case NumberFormat_int8:
+        case NumberFormat_uint16:
+        case NumberFormat_int16:
+        case NumberFormat_uint32:
+        case NumberFormat_int32:
+            break;
+        default:
+            _error = QString("Bit fields need an 8, 16 or 32 bits integer, not \"%1\"!")
+                .arg(numberFormatToStr(field.format));
+            return false;
+    }
+
+    const unsigned totalBits = sampleSize(field.format) * 8;
+    unsigned shift = 0;
+    for (auto b : bits.split('|'))
+    {
+        b = b.trimmed();
+        bool skip = b.startsWith('x');
+        bool isSigned = b.startsWith('s');
+        if (skip || isSigned) b = b.mid(1);
+
+        bool ok;
+        unsigned width = b.toUInt(&ok);
+        if (!ok || width == 0 || shift + width > totalBits)
+        {
+            _error = QString("Invalid bit fields \"{%1}\"!").arg(bits);
+            return false;
+        }
+
+        if (!skip)
+        {
+            Field part = field;
+            part.bitShift = shift;
+            part.bitWidth = width;
+            part.bitSigned = isSigned;
+            parts.append(part);
+        }
+        shift += width;
+    }
+
+    if (parts.isEmpty())
+    {
+        _error = QString("Bit fields \"{%1}\" have no channels!").arg(bits);
+        return false;
+    }
+    return true;
+}
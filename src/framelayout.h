@@ -0,0 +1,93 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FRAMELAYOUT_H
+#define FRAMELAYOUT_H
+
+#include <QString>
+#include <QVector>
+
+#include "numberformat.h"
+#include "endiannessbox.h"
+
+/**
+ * Layout of a package of mixed type samples, such as a `uint32`
+ * counter followed by `int16` axes and a `float` temperature.
+ *
+ * Layout is written as a comma separated list of fields:
+ *
+ *     [count*]type[{bits|bits...}][:le|:be][@offset]
+ *
+ * `type` is a number format name (see `numberFormatToStr()`) or
+ * `pad` for an ignored byte. A field without an offset is placed
+ * right after the previous one and a field without a byte order uses
+ * the default (selected) byte order. Each field except padding is a
+ * channel, in the order they are written.
+ *
+ * An 8, 16 or 32 bits integer can be split into bit fields, each one
+ * is a channel. Widths are listed starting from the least significant
+ * bit, `s` prefix makes a field signed and `x` prefix skips bits.
+ * Bit packed number formats can't be used in a layout.
+ *
+ * Example: `uint32, 3*int16, pad, 2*float:be, uint16{12|x2|s2}`
+ */
+class FrameLayout
+{
+public:
+    struct Field
+    {
+        NumberFormat format;
+        unsigned offset;         ///< from the start of package, in bytes
+        bool defaultEndianness;  ///< byte order isn't specified
+        Endianness endianness;   ///< only valid if not `defaultEndianness`
+        unsigned bitShift;       ///< first bit of a bit field
+        unsigned bitWidth;       ///< `0` if field is not a bit field
+        bool bitSigned;          ///< bit field is sign extended
+    };
+
+    /// Creates an empty layout
+    FrameLayout();
+    /// Parses a layout description, check `isValid()` for errors.
+    explicit FrameLayout(QString text);
+
+    /// Layout has no fields, either it's empty or invalid
+    bool isEmpty() const {return _fields.isEmpty();};
+    bool isValid() const {return _error.isEmpty();};
+    /// Describes the parsing error if layout is invalid
+    QString errorString() const {return _error;};
+    /// Channel fields, padding is not included
+    const QVector<Field>& fields() const {return _fields;};
+    unsigned numChannels() const {return _fields.size();};
+    /// Size of a package in bytes, including padding
+    unsigned size() const {return _size;};
+
+private:
+    QVector<Field> _fields;
+    unsigned _size;
+    QString _error;
+
+    /// Parses a single `[count*]type[{bits}][:le|:be][@offset]`
+    /// item. `offset` is the position of the field if it doesn't have
+    /// one, it's updated to the end of the item.
+    bool parseItem(QString item, unsigned& offset);
+    /// Splits `field` into bit fields described by `bits`, appends them to `parts`
+    bool parseBitFields(QString bits, const Field& field, QVector<Field>& parts);
+};
+
+#endif // FRAMELAYOUT_H
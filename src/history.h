@@ -0,0 +1,70 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "framebuffer.h"
+
+/**
+ * Append only storage for samples of all channels that don't fit into
+ * the stream buffer anymore.
+ *
+ * Samples are added in 2 steps. First samples of each channel are
+ * written with `append()`, then they are made visible with `commit()`.
+ */
+class History
+{
+public:
+    /// Placeholder virtual destructor
+    virtual ~History() {};
+
+    virtual unsigned numChannels() const = 0;
+    /// Returns number of (committed) samples of a channel
+    virtual unsigned size() const = 0;
+
+    /**
+     * Writes samples of a channel after the committed ones.
+     *
+     * @param ci channel index
+     * @param offset index of first sample relative to `size()`
+     * @param samples samples to write
+     * @param n number of samples
+     */
+    virtual void append(unsigned ci, unsigned offset, const double* samples, unsigned n) = 0;
+    /// Same as above but samples are copied from a buffer starting
+    /// from index `start`.
+    virtual void append(unsigned ci, unsigned offset, const FrameBuffer* buffer,
+                        unsigned start, unsigned n) = 0;
+    /// Makes `n` appended samples of all channels visible
+    virtual void commit(unsigned n) = 0;
+    /// Removes all samples
+    virtual void clear() = 0;
+    /// Returns true if samples can't be stored anymore, for example
+    /// after an I/O error. Stored samples are lost in that case.
+    virtual bool failed() const {return false;};
+
+    virtual double sample(unsigned ci, unsigned i) const = 0;
+    /// Returns minimum and maximum of `n` samples starting from
+    /// `start`. `n` must be bigger than 0.
+    virtual Range limits(unsigned ci, unsigned start, unsigned n) const = 0;
+    virtual void copyRange(unsigned ci, unsigned start, unsigned n, double* out) const = 0;
+};
+
+#endif // HISTORY_H
@@ -0,0 +1,165 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <algorithm>
+#include <math.h>
+
+#include "historybuffer.h"
+
+HistoryBuffer::HistoryBuffer(const History* history, unsigned ci,
+                             const FrameBuffer* recent)
+{
+    _history = history;
+    _ci = ci;
+    _recent = recent;
+}
+
+unsigned HistoryBuffer::size() const
+{
+    return _history->size() + _recent->size();
+}
+
+double HistoryBuffer::sample(unsigned i) const
+{
+    unsigned hsize = _history->size();
+    if (i < hsize)
+    {
+        return _history->sample(_ci, i);
+    }
+    else
+    {
+        return _recent->sample(i - hsize);
+    }
+}
+
+Range HistoryBuffer::limits() const
+{
+    return limits(0, size());
+}
+
+Range HistoryBuffer::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= size());
+
+    unsigned hsize = _history->size();
+    if (start >= hsize) // only recent
+    {
+        return _recent->limits(start - hsize, n);
+    }
+    else if (start + n <= hsize) // only history
+    {
+        return _history->limits(_ci, start, n);
+    }
+
+    unsigned x = hsize - start; // number of samples in history
+    Range a = _history->limits(_ci, start, x);
+    Range b = _recent->limits(0, n - x);
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+void HistoryBuffer::copyRange(unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= size());
+
+    unsigned hsize = _history->size();
+    unsigned x = start < hsize ? std::min(n, hsize - start) : 0; // from history
+    if (x)
+    {
+        _history->copyRange(_ci, start, x, out);
+    }
+    if (n > x)
+    {
+        _recent->copyRange(start + x - hsize, n - x, out + x);
+    }
+}
+
+HistoryXBuffer::HistoryXBuffer(const History* history, const XFrameBuffer* recent)
+{
+    _history = history;
+    _recent = recent;
+}
+
+unsigned HistoryXBuffer::size() const
+{
+    return _history->size() + _recent->size();
+}
+
+double HistoryXBuffer::step() const
+{
+    return _recent->sample(1) - _recent->sample(0);
+}
+
+double HistoryXBuffer::sample(unsigned i) const
+{
+    unsigned hsize = _history->size();
+    if (i < hsize)
+    {
+        return _recent->sample(0) - (hsize - i) * step();
+    }
+    else
+    {
+        return _recent->sample(i - hsize);
+    }
+}
+
+Range HistoryXBuffer::limits() const
+{
+    return {sample(0), sample(size()-1)};
+}
+
+Range HistoryXBuffer::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= size());
+    return {sample(start), sample(start + n - 1)};
+}
+
+void HistoryXBuffer::copyRange(unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= size());
+    for (unsigned i = 0; i < n; i++)
+    {
+        out[i] = sample(start + i);
+    }
+}
+
+int HistoryXBuffer::findIndex(double value) const
+{
+    unsigned hsize = _history->size();
+    double first = _recent->sample(0);
+    if (value >= first)
+    {
+        int index = _recent->findIndex(value);
+        return index == OUT_OF_RANGE ? OUT_OF_RANGE : index + hsize;
+    }
+
+    // value is in history
+    double index = hsize - ceil((first - value) / step());
+    if (index < 0)
+    {
+        return OUT_OF_RANGE;
+    }
+    return index;
+}
+
+void HistoryXBuffer::resize(unsigned n)
+{
+    Q_UNUSED(n);
+    Q_ASSERT(false);
+}
@@ -0,0 +1,84 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HISTORYBUFFER_H
+#define HISTORYBUFFER_H
+
+#include "framebuffer.h"
+#include "history.h"
+
+/**
+ * A read only buffer that spans both the history (older samples)
+ * and the recent samples of a channel.
+ *
+ * Size of the buffer grows as samples are moved into history.
+ */
+class HistoryBuffer : public FrameBuffer
+{
+public:
+    /**
+     * @param history history of the stream
+     * @param ci channel index in history
+     * @param recent buffer of recent samples of the channel
+     */
+    HistoryBuffer(const History* history, unsigned ci, const FrameBuffer* recent);
+
+    unsigned size() const override;
+    double sample(unsigned i) const override;
+    Range limits() const override;
+    Range limits(unsigned start, unsigned n) const override;
+    void copyRange(unsigned start, unsigned n, double* out) const override;
+
+private:
+    const History* _history;
+    unsigned _ci;
+    const FrameBuffer* _recent;
+};
+
+/**
+ * X buffer matching the `HistoryBuffer`.
+ *
+ * X values of the history are extrapolated backwards from the first
+ * 2 values of the recent X buffer, which is expected to be evenly
+ * spaced (`IndexBuffer` or `LinIndexBuffer`).
+ */
+class HistoryXBuffer : public XFrameBuffer
+{
+public:
+    HistoryXBuffer(const History* history, const XFrameBuffer* recent);
+
+    unsigned size() const override;
+    double sample(unsigned i) const override;
+    Range limits() const override;
+    Range limits(unsigned start, unsigned n) const override;
+    void copyRange(unsigned start, unsigned n, double* out) const override;
+    int findIndex(double value) const override;
+    /// Size follows the history and recent buffer, this shouldn't
+    /// be called.
+    void resize(unsigned n) override;
+
+private:
+    const History* _history;
+    const XFrameBuffer* _recent;
+
+    /// Distance between 2 samples
+    double step() const;
+};
+
+#endif // HISTORYBUFFER_H
@@ -0,0 +1,242 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <QDir>
+#include <QtDebug>
+#include <algorithm>
+#include <limits>
+
+#include "historyfile.h"
+
+/// Limits of an empty block, it doesn't change the result when merged
+static const Range EMPTY_LIMITS = {std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity()};
+
+static inline Range merge(const Range& a, const Range& b)
+{
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+static Range scan(const double* data, unsigned n)
+{
+    Range lim = EMPTY_LIMITS;
+    for (unsigned i = 0; i < n; i++)
+    {
+        if (data[i] > lim.end) lim.end = data[i];
+        if (data[i] < lim.start) lim.start = data[i];
+    }
+    return lim;
+}
+
+HistoryFile::HistoryFile(unsigned nc) :
+    file(QDir::temp().filePath("serialplot-history-XXXXXX"))
+{
+    _numChannels = nc;
+    _size = 0;
+    capacity = 0;
+    data = nullptr;
+
+    if (!file.open())
+    {
+        qCritical() << "Failed to create history file:" << file.errorString();
+    }
+}
+
+HistoryFile::~HistoryFile()
+{
+    // file is unmapped and removed by QTemporaryFile
+}
+
+bool HistoryFile::isOpen() const
+{
+    return file.isOpen();
+}
+
+bool HistoryFile::failed() const
+{
+    return !file.isOpen();
+}
+
+unsigned HistoryFile::numChannels() const
+{
+    return _numChannels;
+}
+
+unsigned HistoryFile::size() const
+{
+    return _size;
+}
+
+bool HistoryFile::reserve(unsigned n)
+{
+    if (n <= capacity) return true;
+    if (!file.isOpen()) return false;
+
+    // grow at least 2 times to keep the number of re-maps low,
+    // capacity is limited to what `unsigned` can index
+    const quint64 maxBlocks = std::numeric_limits<unsigned>::max() / BLOCK_SIZE;
+    quint64 blocks = (std::max(quint64(n), 2 * quint64(capacity)) + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    blocks = std::min(blocks, maxBlocks);
+    if (blocks * BLOCK_SIZE < n)
+    {
+        qCritical() << "History is too long, dropped" << _size << "samples.";
+        drop();
+        return false;
+    }
+    qint64 bytes = qint64(blocks) * BLOCK_SIZE * _numChannels * sizeof(double);
+
+    if (data != nullptr)
+    {
+        file.unmap(reinterpret_cast<uchar*>(data));
+        data = nullptr;
+    }
+
+    uchar* mapped = nullptr;
+    if (file.resize(bytes))
+    {
+        mapped = file.map(0, bytes);
+    }
+    if (mapped == nullptr)
+    {
+        qCritical() << "Failed to grow history file, dropped" << _size << "samples:"
+                    << file.errorString();
+        drop();
+        return false;
+    }
+
+    data = reinterpret_cast<double*>(mapped);
+    capacity = blocks * BLOCK_SIZE;
+    blockLimits.resize(blocks * _numChannels);
+    return true;
+}
+
+void HistoryFile::drop()
+{
+    if (data != nullptr)
+    {
+        file.unmap(reinterpret_cast<uchar*>(data));
+        data = nullptr;
+    }
+    file.close();
+    capacity = 0;
+    _size = 0;
+    blockLimits.clear();
+}
+
+template <typename F>
+void HistoryFile::forEachPart(unsigned ci, unsigned start, unsigned n, F write) const
+{
+    unsigned done = 0;
+    while (done < n)
+    {
+        unsigned i = start + done;
+        unsigned count = std::min(n - done, BLOCK_SIZE - i % BLOCK_SIZE);
+        write(at(ci, i), done, count);
+        done += count;
+    }
+}
+
+void HistoryFile::append(unsigned ci, unsigned offset, const double* samples, unsigned n)
+{
+    Q_ASSERT(ci < _numChannels);
+
+    unsigned start = _size + offset;
+    if (n == 0 || !reserve(start + n)) return;
+
+    forEachPart(ci, start, n, [samples](double* dst, unsigned index, unsigned count)
+                {
+                    std::copy(samples + index, samples + index + count, dst);
+                });
+    updateLimits(ci, start, n);
+}
+
+void HistoryFile::append(unsigned ci, unsigned offset, const FrameBuffer* buffer,
+                         unsigned start, unsigned n)
+{
+    Q_ASSERT(ci < _numChannels);
+
+    unsigned hstart = _size + offset;
+    if (n == 0 || !reserve(hstart + n)) return;
+
+    forEachPart(ci, hstart, n, [buffer, start](double* dst, unsigned index, unsigned count)
+                {
+                    buffer->copyRange(start + index, count, dst);
+                });
+    updateLimits(ci, hstart, n);
+}
+
+void HistoryFile::updateLimits(unsigned ci, unsigned start, unsigned n)
+{
+    forEachPart(ci, start, n, [this, ci, start](double* dst, unsigned index, unsigned count)
+                {
+                    unsigned i = start + index;
+                    Range& lim = blockLimits[(i / BLOCK_SIZE) * _numChannels + ci];
+                    // samples are only added to the end of a block
+                    if (i % BLOCK_SIZE == 0) lim = EMPTY_LIMITS;
+                    lim = merge(lim, scan(dst, count));
+                });
+}
+
+void HistoryFile::commit(unsigned n)
+{
+    if (!reserve(_size + n)) return;
+    _size += n;
+}
+
+void HistoryFile::clear()
+{
+    _size = 0;
+}
+
+double HistoryFile::sample(unsigned ci, unsigned i) const
+{
+    Q_ASSERT(ci < _numChannels && i < _size);
+    return *at(ci, i);
+}
+
+Range HistoryFile::limits(unsigned ci, unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= _size);
+
+    Range lim = EMPTY_LIMITS;
+    forEachPart(ci, start, n, [this, ci, start, &lim](double* src, unsigned index, unsigned count)
+                {
+                    unsigned i = start + index;
+                    if (count == BLOCK_SIZE) // whole block
+                    {
+                        lim = merge(lim, blockLimits[(i / BLOCK_SIZE) * _numChannels + ci]);
+                    }
+                    else
+                    {
+                        lim = merge(lim, scan(src, count));
+                    }
+                });
+    return lim;
+}
+
+void HistoryFile::copyRange(unsigned ci, unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= _size);
+
+    forEachPart(ci, start, n, [out](double* src, unsigned index, unsigned count)
+                {
+                    std::copy(src, src + count, out + index);
+                });
+}
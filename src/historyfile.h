@@ -0,0 +1,95 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HISTORYFILE_H
+#define HISTORYFILE_H
+
+#include <QTemporaryFile>
+#include <QVector>
+
+#include "history.h"
+
+/**
+ * `History` that is stored on disk.
+ *
+ * Samples are kept in a temporary file that is mapped into memory,
+ * so that reading is served by the OS page cache and RAM use stays
+ * bounded. File is deleted when this object is destroyed.
+ *
+ * File is made of blocks of `BLOCK_SIZE` samples for each
+ * channel. Channels are stored one after the other in a block, so
+ * that a range of a channel is read from a few contiguous
+ * arrays. Minimum and maximum of each block is kept in memory.
+ */
+class HistoryFile : public History
+{
+public:
+    /// Number of samples of a channel in a block
+    static const unsigned BLOCK_SIZE = 4096;
+
+    /// Creates the file, check with `isOpen()` for errors.
+    explicit HistoryFile(unsigned nc);
+    ~HistoryFile();
+
+    /// Returns false if file couldn't be created
+    bool isOpen() const;
+    unsigned numChannels() const override;
+    unsigned size() const override;
+    void append(unsigned ci, unsigned offset, const double* samples, unsigned n) override;
+    void append(unsigned ci, unsigned offset, const FrameBuffer* buffer,
+                unsigned start, unsigned n) override;
+    void commit(unsigned n) override;
+    void clear() override;
+    /// File is closed after an error
+    bool failed() const override;
+    double sample(unsigned ci, unsigned i) const override;
+    Range limits(unsigned ci, unsigned start, unsigned n) const override;
+    void copyRange(unsigned ci, unsigned start, unsigned n, double* out) const override;
+
+private:
+    QTemporaryFile file;
+    unsigned _numChannels;
+    unsigned _size;
+    unsigned capacity;         ///< number of samples of a channel that fit in file
+    double* data;              ///< mapped file
+    QVector<Range> blockLimits; ///< limits of blocks, `numChannels` entries per block
+
+    /// Returns the position of a sample in `data`
+    double* at(unsigned ci, unsigned i) const
+    {
+        return data + (size_t(i / BLOCK_SIZE) * _numChannels + ci) * BLOCK_SIZE + i % BLOCK_SIZE;
+    }
+
+    /// Grows the file to fit at least `n` samples for each channel.
+    /// Returns false in case of error.
+    bool reserve(unsigned n);
+    /// Closes the file after an error, all history is lost
+    void drop();
+
+    /// Calls `write(dst, index, count)` for each contiguous part of
+    /// `n` samples starting from `start` of a channel, `index` being
+    /// the number of samples before this part.
+    template <typename F>
+    void forEachPart(unsigned ci, unsigned start, unsigned n, F write) const;
+
+    /// Updates block limits after samples are written
+    void updateLimits(unsigned ci, unsigned start, unsigned n);
+};
+
+#endif // HISTORYFILE_H
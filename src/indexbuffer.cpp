@@ -48,6 +48,21 @@ Range IndexBuffer::limits() const
     return Range{0, _size-1.};
 }
 
+Range IndexBuffer::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= _size);
+    return Range{double(start), start + n - 1.};
+}
+
+void IndexBuffer::copyRange(unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= _size);
+    for (unsigned i = 0; i < n; i++)
+    {
+        out[i] = start + i;
+    }
+}
+
 int IndexBuffer::findIndex(double value) const
 {
     if (value < 0 || value > size() - 1)
@@ -34,6 +34,8 @@ public:
     unsigned size() const override;
     double sample(unsigned i) const override;
     Range limits() const override;
+    Range limits(unsigned start, unsigned n) const override;
+    void copyRange(unsigned start, unsigned n, double* out) const override;
     void resize(unsigned n) override;
     int findIndex(double value) const override;
 
@@ -0,0 +1,102 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+
+#include "labelindex.h"
+
+/// Initial size of the hash table
+static const unsigned INITIAL_TABLE_SIZE = 16;
+
+LabelIndex::LabelIndex()
+{
+    table.fill(0, INITIAL_TABLE_SIZE);
+}
+
+quint32 LabelIndex::hash(const char* label, unsigned size)
+{
+    // FNV-1a
+    quint32 h = 2166136261u;
+    for (unsigned i = 0; i < size; i++)
+    {
+        h ^= (unsigned char) label[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int LabelIndex::find(const char* label, unsigned size) const
+{
+    const quint32 h = hash(label, size);
+    const unsigned mask = table.size() - 1;
+
+    // linear probing, there is always an empty slot
+    for (unsigned s = h & mask; table[s]; s = (s + 1) & mask)
+    {
+        unsigned i = table[s] - 1;
+        if (hashes[i] == h && (unsigned) labels[i].size() == size &&
+            memcmp(labels[i].constData(), label, size) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+unsigned LabelIndex::insert(const char* label, unsigned size)
+{
+    Q_ASSERT(find(label, size) < 0);
+
+    unsigned index = labels.size();
+    labels.append(QByteArray(label, size));
+    hashes.append(hash(label, size));
+
+    if (2 * labels.size() > table.size())
+    {
+        rehash(2 * table.size());
+    }
+    else
+    {
+        const unsigned mask = table.size() - 1;
+        unsigned s = hashes[index] & mask;
+        while (table[s]) s = (s + 1) & mask;
+        table[s] = index + 1;
+    }
+
+    return index;
+}
+
+void LabelIndex::rehash(unsigned tableSize)
+{
+    table.fill(0, tableSize);
+    const unsigned mask = tableSize - 1;
+    for (int i = 0; i < labels.size(); i++)
+    {
+        unsigned s = hashes[i] & mask;
+        while (table[s]) s = (s + 1) & mask;
+        table[s] = i + 1;
+    }
+}
+
+void LabelIndex::clear()
+{
+    labels.clear();
+    hashes.clear();
+    rehash(INITIAL_TABLE_SIZE);
+}
@@ -0,0 +1,69 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LABELINDEX_H
+#define LABELINDEX_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * Maps text labels to consecutive indexes.
+ *
+ * Labels are kept in an open addressing hash table that is looked up
+ * directly with a pointer and size, so finding a label in a buffer
+ * doesn't require creating a `QByteArray` (or any allocation).
+ */
+class LabelIndex
+{
+public:
+    LabelIndex();
+
+    /// Number of labels
+    unsigned size() const {return labels.size();};
+
+    /// Returns the index of the label or `-1` if it's not added
+    int find(const char* label, unsigned size) const;
+
+    /// Adds a new label and returns its index, which is the number of
+    /// labels before adding.
+    ///
+    /// @note Label shouldn't be already added.
+    unsigned insert(const char* label, unsigned size);
+
+    /// Returns the label of index `i`
+    const QByteArray& label(unsigned i) const {return labels[i];};
+
+    /// Removes all labels
+    void clear();
+
+private:
+    QVector<QByteArray> labels;
+    QVector<quint32> hashes;    ///< hashes of `labels`, same order
+    /// Hash table, contains `index + 1` of a label, `0` means empty
+    /// slot. Size is a power of 2 and kept at least twice the number
+    /// of labels.
+    QVector<unsigned> table;
+
+    static quint32 hash(const char* label, unsigned size);
+    /// Re-builds the table with given size
+    void rehash(unsigned tableSize);
+};
+
+#endif // LABELINDEX_H
@@ -0,0 +1,183 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <limits>
+
+#include "limitstree.h"
+
+/// Limits of an empty block, it doesn't change the result when merged
+static const Range EMPTY_LIMITS = {std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity()};
+
+static inline Range merge(const Range& a, const Range& b)
+{
+    return {b.start < a.start ? b.start : a.start,
+            b.end > a.end ? b.end : a.end};
+}
+
+template <typename T>
+LimitsTree<T>::LimitsTree()
+{
+    _data = nullptr;
+    _size = 0;
+    numBlocks = 0;
+    numLeaves = 1;
+    nodes = new Range[2];
+    nodes[1] = EMPTY_LIMITS;
+}
+
+template <typename T>
+LimitsTree<T>::~LimitsTree()
+{
+    delete[] nodes;
+}
+
+template <typename T>
+void LimitsTree<T>::setData(const T* data, unsigned size)
+{
+    _data = data;
+    _size = size;
+    numBlocks = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    numLeaves = 1;
+    while (numLeaves < numBlocks) numLeaves *= 2;
+
+    delete[] nodes;
+    nodes = new Range[2 * numLeaves];
+
+    for (unsigned b = 0; b < numBlocks; b++)
+    {
+        updateBlock(b);
+    }
+    for (unsigned i = numLeaves + numBlocks; i < 2 * numLeaves; i++)
+    {
+        nodes[i] = EMPTY_LIMITS;
+    }
+    for (unsigned i = numLeaves - 1; i > 0; i--)
+    {
+        nodes[i] = merge(nodes[2*i], nodes[2*i+1]);
+    }
+}
+
+template <typename T>
+void LimitsTree<T>::update(unsigned start, unsigned n)
+{
+    Q_ASSERT(start + n <= _size);
+
+    if (n == 0) return;
+
+    unsigned firstBlock = start / BLOCK_SIZE;
+    unsigned lastBlock = (start + n - 1) / BLOCK_SIZE;
+
+    for (unsigned b = firstBlock; b <= lastBlock; b++)
+    {
+        updateBlock(b);
+    }
+
+    // update parents of changed leaves, level by level
+    unsigned l = (numLeaves + firstBlock) / 2;
+    unsigned r = (numLeaves + lastBlock) / 2;
+    while (l > 0)
+    {
+        for (unsigned i = l; i <= r; i++)
+        {
+            nodes[i] = merge(nodes[2*i], nodes[2*i+1]);
+        }
+        l /= 2;
+        r /= 2;
+    }
+}
+
+template <typename T>
+Range LimitsTree<T>::limits() const
+{
+    return nodes[1];
+}
+
+template <typename T>
+Range LimitsTree<T>::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= _size);
+
+    unsigned end = start + n;
+
+    // blocks that are completely covered by the range
+    unsigned firstFull = (start + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    unsigned endFull = (end == _size) ? numBlocks : end / BLOCK_SIZE;
+
+    if (firstFull >= endFull) // range is inside a single block
+    {
+        return scan(start, end);
+    }
+
+    Range lim = EMPTY_LIMITS;
+    if (start < firstFull * BLOCK_SIZE)
+    {
+        lim = scan(start, firstFull * BLOCK_SIZE);
+    }
+    if (endFull * BLOCK_SIZE < end)
+    {
+        lim = merge(lim, scan(endFull * BLOCK_SIZE, end));
+    }
+
+    // merge nodes covering [firstFull, endFull) from bottom up
+    for (unsigned l = numLeaves + firstFull, r = numLeaves + endFull;
+         l < r; l /= 2, r /= 2)
+    {
+        if (l & 1) lim = merge(lim, nodes[l++]);
+        if (r & 1) lim = merge(lim, nodes[--r]);
+    }
+
+    return lim;
+}
+
+template <typename T>
+void LimitsTree<T>::updateBlock(unsigned block)
+{
+    unsigned start = block * BLOCK_SIZE;
+    unsigned end = start + BLOCK_SIZE;
+    if (end > _size) end = _size;
+
+    nodes[numLeaves + block] = scan(start, end);
+}
+
+template <typename T>
+Range LimitsTree<T>::scan(unsigned start, unsigned end) const
+{
+    // NaN samples (gaps) fail both comparisons and are skipped
+    Range lim = EMPTY_LIMITS;
+    for (unsigned i = start; i < end; i++)
+    {
+        double v = _data[i];
+        if (v > lim.end) lim.end = v;
+        if (v < lim.start) lim.start = v;
+    }
+    return lim;
+}
+
+// sample types that are used for storage
+template class LimitsTree<double>;
+template class LimitsTree<float>;
+template class LimitsTree<qint8>;
+template class LimitsTree<quint8>;
+template class LimitsTree<qint16>;
+template class LimitsTree<quint16>;
+template class LimitsTree<qint32>;
+template class LimitsTree<quint32>;
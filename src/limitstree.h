@@ -0,0 +1,83 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LIMITSTREE_H
+#define LIMITSTREE_H
+
+#include "framebuffer.h"
+
+/**
+ * Keeps track of the minimum and maximum values of an array.
+ *
+ * Array is divided into fixed size blocks. Limits of each block are
+ * stored as the leaves of a segment tree, so that when a part of the
+ * array is changed only the touched blocks are re-scanned and limits
+ * of the whole array is always available at the root of the tree.
+ *
+ * `T` is the element type of the array. Limits are always reported
+ * as `double`.
+ *
+ * @note Array is not owned or copied. It should be kept alive as long
+ * as it's set.
+ */
+template <typename T>
+class LimitsTree
+{
+public:
+    /// Number of samples in a block
+    static const unsigned BLOCK_SIZE = 128;
+
+    LimitsTree();
+    ~LimitsTree();
+    LimitsTree(const LimitsTree&) = delete;
+    LimitsTree& operator=(const LimitsTree&) = delete;
+
+    /// Sets the tracked array and re-builds the whole tree.
+    void setData(const T* data, unsigned size);
+
+    /// Updates the tree after `n` samples starting from `start` are
+    /// changed. `start` is the index in the array.
+    void update(unsigned start, unsigned n);
+
+    /// Returns the minimum and maximum of the whole array.
+    Range limits() const;
+
+    /// Returns the minimum and maximum of `n` samples starting from
+    /// `start`. Only the partially covered blocks at both ends are
+    /// scanned, rest is looked up from the tree.
+    ///
+    /// @important `n` must be bigger than 0 and `(start + n)` must be
+    /// smaller or equal to array size.
+    Range limits(unsigned start, unsigned n) const;
+
+private:
+    const T* _data;      ///< tracked array
+    unsigned _size;      ///< size of the `_data`
+    unsigned numBlocks;  ///< number of (used) leaves
+    unsigned numLeaves;  ///< a power of 2, bigger or equal to `numBlocks`
+    Range* nodes;        ///< root is at `1`, leaves start from `numLeaves`
+
+    /// Re-scans a block and updates its leaf
+    void updateBlock(unsigned block);
+    /// Scans the array between `start` (inclusive) and `end`
+    /// (exclusive), NaN values are ignored
+    Range scan(unsigned start, unsigned end) const;
+};
+
+#endif // LIMITSTREE_H
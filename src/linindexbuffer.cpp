@@ -46,12 +46,27 @@ Range LinIndexBuffer::limits() const
     return _limits;
 }
 
+Range LinIndexBuffer::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= _size);
+    return Range{sample(start), sample(start + n - 1)};
+}
+
 void LinIndexBuffer::resize(unsigned n)
 {
     _size = n;
     setLimits(_limits);         // called to update `_step`
 }
 
+void LinIndexBuffer::copyRange(unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= _size);
+    for (unsigned i = 0; i < n; i++)
+    {
+        out[i] = sample(start + i);
+    }
+}
+
 int LinIndexBuffer::findIndex(double value) const
 {
     if (value < _limits.start || value > _limits.end)
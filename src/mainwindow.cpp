@@ -184,6 +184,11 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(&plotControlPanel, &PlotControlPanel::plotWidthChanged,
             plotMan, &PlotManager::setPlotWidth);
 
+    connect(&plotControlPanel, &PlotControlPanel::historyChanged,
+            &stream, &Stream::setHistoryEnabled);
+    connect(&plotControlPanel, &PlotControlPanel::historyInMemoryChanged,
+            &stream, &Stream::setHistoryInMemory);
+
     // plot toolbar signals
     QObject::connect(ui->actionClear, SIGNAL(triggered(bool)),
                      this, SLOT(clearPlot()));
@@ -234,6 +239,8 @@ MainWindow::MainWindow(QWidget *parent) :
                       plotControlPanel.xMin(), plotControlPanel.xMax());
     plotMan->setNumOfSamples(numOfSamples);
     plotMan->setPlotWidth(plotControlPanel.plotWidth());
+    stream.setHistoryInMemory(plotControlPanel.historyInMemory());
+    stream.setHistoryEnabled(plotControlPanel.history());
 
     // init bps (bits per second) counter
     ui->statusBar->addPermanentWidget(&bpsLabel);
@@ -262,6 +269,13 @@ MainWindow::MainWindow(QWidget *parent) :
             this, &MainWindow::onSourceChanged);
     onSourceChanged(dataFormatPanel.activeSource());
 
+    connect(&dataFormatPanel, &DataFormatPanel::channelNameChanged,
+            [this](unsigned channel, QString name)
+            {
+                auto model = stream.infoModel();
+                model->setData(model->index(channel, ChannelInfoModel::COLUMN_NAME), name);
+            });
+
     // load default settings
     QSettings settings(PROGRAM_NAME, PROGRAM_NAME);
     loadAllSettings(&settings);
@@ -399,6 +413,14 @@ void MainWindow::onSpsChanged(float sps)
 {
     int precision = sps < 1. ? 3 : 0;
     spsLabel.setText(QString::number(sps, 'f', precision) + "sps");
+
+    // latency from capture of the samples to the stream
+    QString tooltip = tr("samples per second (per channel)");
+    if (sampleCounter.latency() >= 0)
+    {
+        tooltip += tr("\nlatency: %1 ms").arg(sampleCounter.latency() / 1e6, 0, 'f', 1);
+    }
+    spsLabel.setToolTip(tooltip);
 }
 
 bool MainWindow::isDemoRunning()
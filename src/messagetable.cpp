@@ -0,0 +1,96 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QStringList>
+
+#include "messagetable.h"
+#include "defines.h"
+
+MessageTable::MessageTable()
+{
+    clear();
+}
+
+MessageTable::MessageTable(QString text)
+{
+    clear();
+    if (text.trimmed().isEmpty()) return;
+
+    for (auto item : text.split(';'))
+    {
+        item = item.trimmed();
+        if (item.isEmpty()) continue; // allow a trailing ';'
+
+        int colon = item.indexOf(':');
+        if (colon < 0)
+        {
+            _error = QString("Missing ':' after message ID in \"%1\"!").arg(item);
+            clear();
+            return;
+        }
+
+        // leading zeros don't mean octal
+        bool ok;
+        QString idStr = item.left(colon).trimmed();
+        unsigned id = idStr.startsWith("0x", Qt::CaseInsensitive) ?
+            idStr.mid(2).toUInt(&ok, 16) : idStr.toUInt(&ok, 10);
+        if (!ok || id > 255)
+        {
+            _error = QString("Invalid message ID in \"%1\"!").arg(item);
+            clear();
+            return;
+        }
+        if (_index[id] >= 0)
+        {
+            _error = QString("Message ID %1 is repeated!").arg(id);
+            clear();
+            return;
+        }
+
+        FrameLayout layout(item.mid(colon + 1));
+        if (!layout.isValid() || layout.isEmpty())
+        {
+            _error = QString("Message %1: %2").arg(id).arg(
+                layout.isValid() ? QString("Layout is empty!") : layout.errorString());
+            clear();
+            return;
+        }
+
+        _index[id] = _messages.size();
+        _messages.append({quint8(id), layout, _numChannels});
+        _numChannels += layout.numChannels();
+    }
+
+    if (_messages.isEmpty())
+    {
+        _error = "Message table has no messages!";
+    }
+    else if (_numChannels > MAX_NUM_CHANNELS)
+    {
+        _error = QString("Messages have more than %1 channels in total!").arg(MAX_NUM_CHANNELS);
+        clear();
+    }
+}
+
+void MessageTable::clear()
+{
+    _messages.clear();
+    _numChannels = 0;
+    for (auto& i : _index) i = -1;
+}
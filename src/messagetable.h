@@ -0,0 +1,81 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MESSAGETABLE_H
+#define MESSAGETABLE_H
+
+#include <QString>
+#include <QVector>
+
+#include "framelayout.h"
+
+/**
+ * Layouts of different frame types that are sent on the same link,
+ * selected by a message ID byte in the frame header.
+ *
+ * Table is written as a semicolon separated list of messages, each
+ * one is an ID (decimal or `0x` prefixed hexadecimal, 0-255) followed
+ * by a `FrameLayout`:
+ *
+ *     id: layout; id: layout ...
+ *
+ * Each message has its own group of channels. Groups are placed one
+ * after the other in the order they are written.
+ *
+ * Example: `1: 6*int16, uint32; 2: 4*float; 0x10: uint8`
+ */
+class MessageTable
+{
+public:
+    struct Message
+    {
+        quint8 id;
+        FrameLayout layout;
+        unsigned firstChannel;  ///< index of the first channel of the group
+    };
+
+    /// Creates an empty table
+    MessageTable();
+    /// Parses a table description, check `isValid()` for errors.
+    explicit MessageTable(QString text);
+
+    /// Table has no messages, either it's empty or invalid
+    bool isEmpty() const {return _messages.isEmpty();};
+    bool isValid() const {return _error.isEmpty();};
+    /// Describes the parsing error if table is invalid
+    QString errorString() const {return _error;};
+    const QVector<Message>& messages() const {return _messages;};
+    /// Total number of channels of all messages
+    unsigned numChannels() const {return _numChannels;};
+
+    /// Returns the index of message with `id` in `messages()`, `-1` if
+    /// there is no such message. Lookup is a single table access.
+    int indexOf(quint8 id) const {return _index[id];};
+
+private:
+    QVector<Message> _messages;
+    qint16 _index[256];         ///< message index for each ID, `-1` if unknown
+    unsigned _numChannels;
+    QString _error;
+
+    /// Clears messages after a parsing error
+    void clear();
+};
+
+#endif // MESSAGETABLE_H
@@ -0,0 +1,513 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <algorithm>
+#include <limits>
+
+#include "multiringbuffer.h"
+#include "ringbuffer.h"
+
+/// Lanes are aligned to this many bytes
+static const unsigned CACHE_LINE_SIZE = 64;
+
+/// Limits of an empty range, it doesn't change the result when merged
+static const Range EMPTY_LIMITS = {std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity()};
+
+static inline Range merge(const Range& a, const Range& b)
+{
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+template <typename T>
+MultiRingBufferOf<T>::MultiRingBufferOf(unsigned nc, unsigned n)
+{
+    allocate(nc, n);
+    headIndex = 0;
+
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        lanes.append(new Lane(this, ci));
+    }
+}
+
+template <typename T>
+MultiRingBufferOf<T>::~MultiRingBufferOf()
+{
+    detachSnapshots();
+    for (auto l : lanes)
+    {
+        delete l;
+    }
+    qFreeAligned(data);
+    delete[] limTrees;
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::allocate(unsigned nc, unsigned n)
+{
+    const unsigned lineSamples = CACHE_LINE_SIZE / sizeof(T);
+
+    _numChannels = nc;
+    _size = n;
+    stride = (n + lineSamples - 1) / lineSamples * lineSamples;
+
+    // allocate at least 1 lane so that `data` is never null
+    size_t bytes = sizeof(T) * stride * std::max(nc, 1u);
+    data = static_cast<T*>(qMallocAligned(bytes, CACHE_LINE_SIZE));
+    Q_ASSERT(data != nullptr);
+    std::fill(data, data + stride * std::max(nc, 1u), T(0));
+
+    limTrees = new LimitsTree<T>[nc];
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        limTrees[ci].setData(lane(ci), n);
+    }
+}
+
+template <typename T>
+unsigned MultiRingBufferOf<T>::numChannels() const
+{
+    return _numChannels;
+}
+
+template <typename T>
+unsigned MultiRingBufferOf<T>::size() const
+{
+    return _size;
+}
+
+template <typename T>
+const FrameBuffer* MultiRingBufferOf<T>::channel(unsigned ci) const
+{
+    Q_ASSERT(ci < _numChannels);
+    return lanes[ci];
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::setNumChannels(unsigned nc)
+{
+    if (nc == _numChannels) return;
+
+    detachSnapshots();
+    T* oldData = data;
+    LimitsTree<T>* oldTrees = limTrees;
+    unsigned oldNum = _numChannels;
+
+    // stride doesn't change so lanes can be copied as they are
+    allocate(nc, _size);
+    unsigned keep = std::min(nc, oldNum);
+    std::copy(oldData, oldData + keep * stride, data);
+    for (unsigned ci = 0; ci < keep; ci++)
+    {
+        limTrees[ci].update(0, _size);
+    }
+
+    qFreeAligned(oldData);
+    delete[] oldTrees;
+
+    while ((unsigned) lanes.size() > nc)
+    {
+        delete lanes.takeLast();
+    }
+    for (unsigned ci = lanes.size(); ci < nc; ci++)
+    {
+        lanes.append(new Lane(this, ci));
+    }
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::resize(unsigned n)
+{
+    Q_ASSERT(n != _size);
+
+    detachSnapshots();
+    T* oldData = data;
+    LimitsTree<T>* oldTrees = limTrees;
+    unsigned oldSize = _size;
+    unsigned oldStride = stride;
+
+    allocate(_numChannels, n);
+
+    // copy in logical order, keeping the end values
+    unsigned start = oldSize > n ? oldSize - n : 0;
+    unsigned offset = n > oldSize ? n - oldSize : 0;
+    for (unsigned ci = 0; ci < _numChannels; ci++)
+    {
+        T* src = oldData + ci * oldStride;
+        T* dst = lane(ci) + offset;
+        for (unsigned i = start; i < oldSize; i++)
+        {
+            unsigned index = headIndex + i;
+            if (index >= oldSize) index -= oldSize;
+            *dst++ = src[index];
+        }
+        limTrees[ci].update(0, n);
+    }
+    headIndex = 0;
+
+    qFreeAligned(oldData);
+    delete[] oldTrees;
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::addSamples(const SamplePack& pack)
+{
+    Q_ASSERT(pack.numChannels() == _numChannels);
+
+    unsigned n = pack.numSamples();
+    if (n >= _size) // new samples don't fit, only keep the end
+    {
+        preserve(0, _size);
+        for (unsigned ci = 0; ci < _numChannels; ci++)
+        {
+            RingBufferOf<T>::store(lane(ci), pack.data(ci) + (n - _size), _size);
+            limTrees[ci].update(0, _size);
+        }
+        headIndex = 0;
+        return;
+    }
+
+    // wrap around is calculated once for all lanes
+    unsigned x = _size - headIndex; // distance of `head` to end
+    unsigned n1 = std::min(n, x);   // samples written at the end
+    unsigned n2 = n - n1;           // samples written at the beginning
+    preserve(headIndex, n1);
+    preserve(0, n2);
+    for (unsigned ci = 0; ci < _numChannels; ci++)
+    {
+        T* l = lane(ci);
+        const double* samples = pack.data(ci);
+        RingBufferOf<T>::store(l + headIndex, samples, n1);
+        limTrees[ci].update(headIndex, n1);
+        if (n2)
+        {
+            RingBufferOf<T>::store(l, samples + n1, n2);
+            limTrees[ci].update(0, n2);
+        }
+    }
+
+    headIndex = n2 ? n2 : headIndex + n1;
+    if (headIndex == _size) headIndex = 0;
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::clear()
+{
+    detachSnapshots();
+    std::fill(data, data + stride * _numChannels, T(0));
+    for (unsigned ci = 0; ci < _numChannels; ci++)
+    {
+        limTrees[ci].update(0, _size);
+    }
+}
+
+template <typename T>
+FrameBuffer* MultiRingBufferOf<T>::snapshot(unsigned ci)
+{
+    Q_ASSERT(ci < _numChannels);
+    return new LaneSnapshot(this, ci);
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::preserve(unsigned start, unsigned n)
+{
+    if (snapshots.isEmpty() || n == 0) return;
+
+    // snapshots remove themselves from the list when fully copied
+    auto list = snapshots;
+    for (auto s : list)
+    {
+        s->preserve(start, n);
+    }
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::detachSnapshots()
+{
+    while (!snapshots.isEmpty())
+    {
+        snapshots.first()->detach();
+    }
+}
+
+template <typename T>
+MultiRingBufferOf<T>::Lane::Lane(const MultiRingBufferOf* buffer, unsigned ci)
+{
+    _buffer = buffer;
+    _ci = ci;
+}
+
+template <typename T>
+unsigned MultiRingBufferOf<T>::Lane::size() const
+{
+    return _buffer->_size;
+}
+
+template <typename T>
+double MultiRingBufferOf<T>::Lane::sample(unsigned i) const
+{
+    unsigned index = _buffer->headIndex + i;
+    if (index >= _buffer->_size) index -= _buffer->_size;
+    return _buffer->lane(_ci)[index];
+}
+
+template <typename T>
+Range MultiRingBufferOf<T>::Lane::limits() const
+{
+    return _buffer->limTrees[_ci].limits();
+}
+
+template <typename T>
+Range MultiRingBufferOf<T>::Lane::limits(unsigned start, unsigned n) const
+{
+    unsigned size = _buffer->_size;
+    Q_ASSERT(n > 0 && start + n <= size);
+
+    const LimitsTree<T>& limTree = _buffer->limTrees[_ci];
+    unsigned index = _buffer->headIndex + start;
+    if (index >= size) index -= size;
+
+    if (index + n <= size) // range doesn't wrap around
+    {
+        return limTree.limits(index, n);
+    }
+
+    unsigned x = size - index; // number of samples until the end of lane
+    Range a = limTree.limits(index, x);
+    Range b = limTree.limits(0, n - x);
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::Lane::copyRange(unsigned start, unsigned n, double* out) const
+{
+    unsigned size = _buffer->_size;
+    Q_ASSERT(start + n <= size);
+
+    const T* l = _buffer->lane(_ci);
+    unsigned index = _buffer->headIndex + start;
+    if (index >= size) index -= size;
+
+    unsigned x = size - index; // number of samples until the end of lane
+    if (n <= x)
+    {
+        std::copy(l + index, l + index + n, out);
+    }
+    else
+    {
+        std::copy(l + index, l + size, out);
+        std::copy(l, l + (n - x), out + x);
+    }
+}
+
+template <typename T>
+MultiRingBufferOf<T>::LaneSnapshot::LaneSnapshot(MultiRingBufferOf* buffer, unsigned ci)
+{
+    Q_ASSERT(buffer->_size > 0);
+
+    _buffer = buffer;
+    _size = buffer->_size;
+    headIndex = buffer->headIndex;
+    numPages = (_size + PAGE_SIZE - 1) / PAGE_SIZE;
+    numShared = numPages;
+    pages = new const T*[numPages];
+    owned = new bool[numPages];
+    pageLimits = new Range[numPages];
+
+    const T* l = buffer->lane(ci);
+    for (unsigned p = 0; p < numPages; p++)
+    {
+        pages[p] = l + p * PAGE_SIZE;
+        owned[p] = false;
+        pageLimits[p] = buffer->limTrees[ci].limits(p * PAGE_SIZE, pageSize(p));
+    }
+
+    buffer->snapshots.append(this);
+}
+
+template <typename T>
+MultiRingBufferOf<T>::LaneSnapshot::~LaneSnapshot()
+{
+    if (_buffer != nullptr)
+    {
+        _buffer->snapshots.removeOne(this);
+    }
+
+    for (unsigned p = 0; p < numPages; p++)
+    {
+        if (owned[p]) delete[] pages[p];
+    }
+    delete[] pages;
+    delete[] owned;
+    delete[] pageLimits;
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::LaneSnapshot::preserve(unsigned start, unsigned n)
+{
+    if (_buffer == nullptr || n == 0) return;
+
+    unsigned first = start / PAGE_SIZE;
+    unsigned last = (start + n - 1) / PAGE_SIZE;
+    for (unsigned p = first; p <= last; p++)
+    {
+        if (owned[p]) continue;
+
+        T* copy = new T[pageSize(p)];
+        std::copy(pages[p], pages[p] + pageSize(p), copy);
+        pages[p] = copy;
+        owned[p] = true;
+        numShared--;
+    }
+
+    if (numShared == 0)
+    {
+        _buffer->snapshots.removeOne(this);
+        _buffer = nullptr;
+    }
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::LaneSnapshot::detach()
+{
+    preserve(0, _size);
+}
+
+template <typename T>
+unsigned MultiRingBufferOf<T>::LaneSnapshot::pageSize(unsigned p) const
+{
+    return p == numPages - 1 ? _size - p * PAGE_SIZE : PAGE_SIZE;
+}
+
+template <typename T>
+unsigned MultiRingBufferOf<T>::LaneSnapshot::size() const
+{
+    return _size;
+}
+
+template <typename T>
+double MultiRingBufferOf<T>::LaneSnapshot::sample(unsigned i) const
+{
+    unsigned index = headIndex + i;
+    if (index >= _size) index -= _size;
+    return pages[index / PAGE_SIZE][index % PAGE_SIZE];
+}
+
+template <typename T>
+Range MultiRingBufferOf<T>::LaneSnapshot::limits() const
+{
+    return laneLimits(0, _size);
+}
+
+template <typename T>
+Range MultiRingBufferOf<T>::LaneSnapshot::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= _size);
+
+    unsigned index = headIndex + start;
+    if (index >= _size) index -= _size;
+
+    if (index + n <= _size) // range doesn't wrap around
+    {
+        return laneLimits(index, index + n);
+    }
+
+    return merge(laneLimits(index, _size), laneLimits(0, index + n - _size));
+}
+
+template <typename T>
+Range MultiRingBufferOf<T>::LaneSnapshot::laneLimits(unsigned start, unsigned end) const
+{
+    // pages that are completely covered by the range
+    unsigned firstFull = (start + PAGE_SIZE - 1) / PAGE_SIZE;
+    unsigned endFull = (end == _size) ? numPages : end / PAGE_SIZE;
+
+    if (firstFull >= endFull)
+    {
+        return scan(start, end);
+    }
+
+    Range lim = EMPTY_LIMITS;
+    for (unsigned p = firstFull; p < endFull; p++)
+    {
+        lim = merge(lim, pageLimits[p]);
+    }
+    if (start < firstFull * PAGE_SIZE)
+    {
+        lim = merge(lim, scan(start, firstFull * PAGE_SIZE));
+    }
+    if (endFull * PAGE_SIZE < end)
+    {
+        lim = merge(lim, scan(endFull * PAGE_SIZE, end));
+    }
+    return lim;
+}
+
+template <typename T>
+Range MultiRingBufferOf<T>::LaneSnapshot::scan(unsigned start, unsigned end) const
+{
+    Range lim = EMPTY_LIMITS;
+    while (start < end)
+    {
+        unsigned p = start / PAGE_SIZE;
+        unsigned base = p * PAGE_SIZE;
+        unsigned pEnd = std::min(end, base + pageSize(p));
+        for (unsigned i = start; i < pEnd; i++)
+        {
+            double s = pages[p][i - base];
+            if (s < lim.start) lim.start = s;
+            if (s > lim.end) lim.end = s;
+        }
+        start = pEnd;
+    }
+    return lim;
+}
+
+template <typename T>
+void MultiRingBufferOf<T>::LaneSnapshot::copyRange(unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= _size);
+
+    unsigned index = headIndex + start;
+    if (index >= _size) index -= _size;
+
+    while (n)
+    {
+        unsigned p = index / PAGE_SIZE;
+        unsigned offset = index % PAGE_SIZE;
+        unsigned c = std::min(n, pageSize(p) - offset);
+        std::copy(pages[p] + offset, pages[p] + offset + c, out);
+        out += c;
+        n -= c;
+        index += c;
+        if (index == _size) index = 0;
+    }
+}
+
+// sample types that are used for storage, see `Stream`
+template class MultiRingBufferOf<double>;
+template class MultiRingBufferOf<float>;
+template class MultiRingBufferOf<qint8>;
+template class MultiRingBufferOf<quint8>;
+template class MultiRingBufferOf<qint16>;
+template class MultiRingBufferOf<quint16>;
+template class MultiRingBufferOf<qint32>;
+template class MultiRingBufferOf<quint32>;
@@ -0,0 +1,181 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MULTIRINGBUFFER_H
+#define MULTIRINGBUFFER_H
+
+#include <QList>
+
+#include "framebuffer.h"
+#include "limitstree.h"
+#include "samplepack.h"
+
+/**
+ * Ring buffer storage for a group of channels that are written
+ * together.
+ *
+ * Channels are stored in lanes of a single allocation and share a
+ * single head index, so a `SamplePack` is committed in one pass. Each
+ * lane starts at a cache line boundary.
+ *
+ * Data of a channel is accessed through the `FrameBuffer` returned
+ * from `channel()`. These stay valid until the channel is removed or
+ * buffer is deleted, also when buffer is resized.
+ *
+ * A copy of a channel can be taken with `snapshot()`. Snapshots share
+ * the storage of the buffer and a page of it is copied only before
+ * it's overwritten.
+ */
+class MultiRingBuffer
+{
+public:
+    /// Placeholder virtual destructor
+    virtual ~MultiRingBuffer() {};
+
+    /// Returns number of channels
+    virtual unsigned numChannels() const = 0;
+    /// Returns number of samples of a channel
+    virtual unsigned size() const = 0;
+    /// Returns the data buffer of a channel
+    virtual const FrameBuffer* channel(unsigned ci) const = 0;
+
+    /// Adds or removes channels. Data of remaining channels is kept,
+    /// new channels are filled with 0.
+    virtual void setNumChannels(unsigned nc) = 0;
+    /// Resizes all channels, end values are kept.
+    ///
+    /// @important Resizing to same value is an error.
+    virtual void resize(unsigned n) = 0;
+    /// Adds samples to all channels. Number of channels of `pack`
+    /// should match, X data is ignored.
+    virtual void addSamples(const SamplePack& pack) = 0;
+    /// Reset all data to 0
+    virtual void clear() = 0;
+
+    /// Returns a read only copy of a channel. Copy shares storage with
+    /// this buffer until that part is overwritten, so taking it
+    /// doesn't copy any samples. Returned buffer is owned by the caller
+    /// and it can outlive this buffer.
+    virtual FrameBuffer* snapshot(unsigned ci) = 0;
+};
+
+/// Implementation of `MultiRingBuffer` that stores samples as `T`.
+/// See `RingBufferOf` for conversion details.
+template <typename T>
+class MultiRingBufferOf : public MultiRingBuffer
+{
+public:
+    MultiRingBufferOf(unsigned nc, unsigned n);
+    ~MultiRingBufferOf();
+    MultiRingBufferOf(const MultiRingBufferOf&) = delete;
+    MultiRingBufferOf& operator=(const MultiRingBufferOf&) = delete;
+
+    unsigned numChannels() const override;
+    unsigned size() const override;
+    const FrameBuffer* channel(unsigned ci) const override;
+    void setNumChannels(unsigned nc) override;
+    void resize(unsigned n) override;
+    void addSamples(const SamplePack& pack) override;
+    void clear() override;
+    FrameBuffer* snapshot(unsigned ci) override;
+
+    /// Snapshots share storage in pages of this many samples. It's a
+    /// multiple of `LimitsTree::BLOCK_SIZE` so that limits of a page
+    /// can be looked up from the tree.
+    static const unsigned PAGE_SIZE = 4096;
+
+private:
+    /// Read only view of a single lane
+    class Lane : public FrameBuffer
+    {
+    public:
+        Lane(const MultiRingBufferOf* buffer, unsigned ci);
+
+        unsigned size() const override;
+        double sample(unsigned i) const override;
+        Range limits() const override;
+        Range limits(unsigned start, unsigned n) const override;
+        void copyRange(unsigned start, unsigned n, double* out) const override;
+
+    private:
+        const MultiRingBufferOf* _buffer;
+        unsigned _ci;          ///< channel index
+    };
+
+    /// Copy-on-write copy of a lane, see `snapshot()`
+    class LaneSnapshot : public FrameBuffer
+    {
+    public:
+        LaneSnapshot(MultiRingBufferOf* buffer, unsigned ci);
+        ~LaneSnapshot();
+
+        unsigned size() const override;
+        double sample(unsigned i) const override;
+        Range limits() const override;
+        Range limits(unsigned start, unsigned n) const override;
+        void copyRange(unsigned start, unsigned n, double* out) const override;
+
+        /// Copies the shared pages that overlap with `n` samples
+        /// starting from lane index `start`. Called before they are
+        /// overwritten.
+        void preserve(unsigned start, unsigned n);
+        /// Copies all shared pages and stops tracking the buffer
+        void detach();
+
+    private:
+        MultiRingBufferOf* _buffer; ///< `nullptr` when detached
+        unsigned _size;
+        unsigned headIndex;    ///< head index of the lane at the time of copy
+        unsigned numPages;
+        unsigned numShared;    ///< number of pages still in `_buffer`
+        const T** pages;       ///< either points to lane or to an owned copy
+        bool* owned;           ///< if page is an owned copy
+        Range* pageLimits;
+
+        /// Returns the number of samples in a page
+        unsigned pageSize(unsigned p) const;
+        /// Limits of lane indexes [start, end), `end` can't be bigger than `_size`
+        Range laneLimits(unsigned start, unsigned end) const;
+        /// Same as `laneLimits()` but always scans the samples
+        Range scan(unsigned start, unsigned end) const;
+    };
+
+    unsigned _numChannels;
+    unsigned _size;            ///< number of samples of a lane
+    unsigned stride;           ///< distance between lane starts, in samples
+    T* data;                   ///< storage, aligned to cache line
+    unsigned headIndex;        ///< indicates the actual `0` index of all lanes
+
+    LimitsTree<T>* limTrees;   ///< one for each lane
+    QList<Lane*> lanes;
+    QList<LaneSnapshot*> snapshots; ///< attached snapshots
+
+    /// Copies the pages that will be overwritten to snapshots
+    void preserve(unsigned start, unsigned n);
+    /// Detaches all snapshots, before storage is re-allocated or cleared
+    void detachSnapshots();
+
+    /// Returns the start of a lane
+    T* lane(unsigned ci) const {return data + ci * stride;};
+
+    /// Allocates zero filled storage and sets up limit trees for it
+    void allocate(unsigned nc, unsigned n);
+};
+
+#endif // MULTIRINGBUFFER_H
@@ -28,7 +28,19 @@ QMap<NumberFormat, QString> mapping({
         {NumberFormat_int8, "int8"},
         {NumberFormat_int16, "int16"},
         {NumberFormat_int32, "int32"},
-        {NumberFormat_float, "float"}
+        {NumberFormat_float, "float"},
+        {NumberFormat_uint64, "uint64"},
+        {NumberFormat_int64, "int64"},
+        {NumberFormat_double, "double"},
+        {NumberFormat_uint24, "uint24"},
+        {NumberFormat_int24, "int24"},
+        {NumberFormat_half, "half"},
+        {NumberFormat_bfloat16, "bfloat16"},
+        {NumberFormat_q16, "q16"},
+        {NumberFormat_q32, "q32"},
+        {NumberFormat_uint10, "uint10"},
+        {NumberFormat_uint12, "uint12"},
+        {NumberFormat_uint14, "uint14"}
     });
 
 QString numberFormatToStr(NumberFormat nf)
@@ -31,6 +31,18 @@ enum NumberFormat
     NumberFormat_int16,
     NumberFormat_int32,
     NumberFormat_float,
+    NumberFormat_uint64,
+    NumberFormat_int64,
+    NumberFormat_double,
+    NumberFormat_uint24,  ///< unsigned 3 bytes integer
+    NumberFormat_int24,   ///< signed 3 bytes integer
+    NumberFormat_half,    ///< IEEE 754 half precision (2 bytes) float
+    NumberFormat_bfloat16, ///< upper 2 bytes of a float
+    NumberFormat_q16,     ///< signed 2 bytes fixed point, fractional bits are configured separately
+    NumberFormat_q32,     ///< signed 4 bytes fixed point, fractional bits are configured separately
+    NumberFormat_uint10,  ///< unsigned 10 bits integer, bit packed (4 samples in 5 bytes)
+    NumberFormat_uint12,  ///< unsigned 12 bits integer, bit packed (2 samples in 3 bytes)
+    NumberFormat_uint14,  ///< unsigned 14 bits integer, bit packed (4 samples in 7 bytes)
     NumberFormat_INVALID ///< used for error cases
 };
 
@@ -20,6 +20,8 @@
 #include "numberformatbox.h"
 #include "ui_numberformatbox.h"
 
+#include "utils.h"
+
 NumberFormatBox::NumberFormatBox(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::NumberFormatBox)
@@ -34,10 +36,29 @@ NumberFormatBox::NumberFormatBox(QWidget *parent) :
     buttonGroup.addButton(ui->rbInt16,  NumberFormat_int16);
     buttonGroup.addButton(ui->rbInt32,  NumberFormat_int32);
     buttonGroup.addButton(ui->rbFloat,  NumberFormat_float);
+    buttonGroup.addButton(ui->rbUint64, NumberFormat_uint64);
+    buttonGroup.addButton(ui->rbInt64,  NumberFormat_int64);
+    buttonGroup.addButton(ui->rbDouble, NumberFormat_double);
+    buttonGroup.addButton(ui->rbUint24, NumberFormat_uint24);
+    buttonGroup.addButton(ui->rbInt24,  NumberFormat_int24);
+    buttonGroup.addButton(ui->rbHalf,   NumberFormat_half);
+    buttonGroup.addButton(ui->rbBFloat16, NumberFormat_bfloat16);
+    buttonGroup.addButton(ui->rbQ16,    NumberFormat_q16);
+    buttonGroup.addButton(ui->rbQ32,    NumberFormat_q32);
+    buttonGroup.addButton(ui->rbUint10, NumberFormat_uint10);
+    buttonGroup.addButton(ui->rbUint12, NumberFormat_uint12);
+    buttonGroup.addButton(ui->rbUint14, NumberFormat_uint14);
 
     QObject::connect(
         &buttonGroup, SIGNAL(buttonToggled(int, bool)),
         this, SLOT(onButtonToggled(int, bool)));
+
+    QObject::connect(
+        ui->spFractionBits, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
+        [this](int value)
+        {
+            emit fractionBitsChanged(value);
+        });
 }
 
 NumberFormatBox::~NumberFormatBox()
@@ -47,7 +68,12 @@ NumberFormatBox::~NumberFormatBox()
 
 void NumberFormatBox::onButtonToggled(int numberFormatId, bool checked)
 {
-    if (checked) emit selectionChanged((NumberFormat) numberFormatId);
+    if (checked)
+    {
+        ui->spFractionBits->setEnabled(numberFormatId == NumberFormat_q16 ||
+                                       numberFormatId == NumberFormat_q32);
+        emit selectionChanged((NumberFormat) numberFormatId);
+    }
 }
 
 NumberFormat NumberFormatBox::currentSelection()
@@ -59,3 +85,13 @@ void NumberFormatBox::setSelection(NumberFormat nf)
 {
     buttonGroup.button(nf)->setChecked(true);
 }
+
+unsigned NumberFormatBox::fractionBits()
+{
+    return ui->spFractionBits->value();
+}
+
+void NumberFormatBox::setFractionBits(unsigned bits)
+{
+    ui->spFractionBits->setValue(bits);
+}
@@ -41,10 +41,16 @@ public:
     NumberFormat currentSelection();
     /// change the currently selected number format
     void setSelection(NumberFormat nf);
+    /// returns number of fraction bits for fixed point formats
+    unsigned fractionBits();
+    /// change number of fraction bits for fixed point formats
+    void setFractionBits(unsigned bits);
 
 signals:
     /// Signaled when number format selection is changed
     void selectionChanged(NumberFormat numberFormat);
+    /// Signaled when number of fraction bits is changed
+    void fractionBitsChanged(unsigned bits);
 
 private:
     Ui::NumberFormatBox *ui;
@@ -0,0 +1,135 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QByteArray>
+#include <QtGlobal>
+
+#include "numberparser.h"
+
+/// Powers of 10 that are exactly representable as `double`
+static const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// Biggest integer below which all integers are exact as `double`
+static const quint64 MAX_EXACT_INT = quint64(1) << 53;
+
+/// Maximum number of digits that is guaranteed to fit in `quint64`
+static const unsigned MAX_DIGITS = 19;
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// Slow but complete parsing, also accepts "nan" and "inf"
+static bool parseNumberSlow(const char* begin, const char* end, double& value)
+{
+    bool ok;
+    value = QByteArray::fromRawData(begin, end - begin).toDouble(&ok);
+    return ok;
+}
+
+bool parseNumber(const char* begin, const char* end, double& value)
+{
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    quint64 mantissa = 0;
+    unsigned numDigits = 0;     // significant digits in `mantissa`
+    bool truncated = false;     // there were more digits than `MAX_DIGITS`
+    bool hasDigits = false;
+    int exp10 = 0;
+
+    // integer part
+    for (; p < end && isDigit(*p); p++)
+    {
+        hasDigits = true;
+        if (numDigits < MAX_DIGITS)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa) numDigits++;
+        }
+        else
+        {
+            truncated = true;
+            exp10++;
+        }
+    }
+
+    // fractional part
+    if (p < end && *p == '.')
+    {
+        p++;
+        for (; p < end && isDigit(*p); p++)
+        {
+            hasDigits = true;
+            if (numDigits < MAX_DIGITS)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa) numDigits++;
+                exp10--;
+            }
+            else
+            {
+                truncated = true;
+            }
+        }
+    }
+
+    if (!hasDigits) return parseNumberSlow(begin, end, value);
+
+    // exponent
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool expNegative = false;
+        if (p < end && (*p == '+' || *p == '-'))
+        {
+            expNegative = (*p == '-');
+            p++;
+        }
+        if (p == end || !isDigit(*p)) return false;
+
+        int e = 0;
+        for (; p < end && isDigit(*p); p++)
+        {
+            if (e < 100000) e = e * 10 + (*p - '0');
+        }
+        exp10 += expNegative ? -e : e;
+    }
+
+    if (p != end) return false; // trailing garbage
+
+    // both mantissa and power of 10 are exact, so is the result
+    if (!truncated && mantissa <= MAX_EXACT_INT && exp10 >= -22 && exp10 <= 22)
+    {
+        double v = double(mantissa);
+        v = exp10 < 0 ? v / POW10[-exp10] : v * POW10[exp10];
+        value = negative ? -v : v;
+        return true;
+    }
+
+    return parseNumberSlow(begin, end, value);
+}
@@ -0,0 +1,36 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef NUMBERPARSER_H
+#define NUMBERPARSER_H
+
+/**
+ * Parses the text between `begin` and `end` as a decimal number into
+ * `value`. Returns `false` if the whole text isn't a valid number.
+ *
+ * Parsing is locale independent, '.' is always the decimal
+ * separator. Common numbers (up to 15 significant digits and small
+ * exponents) are converted directly with exact results, others are
+ * handed over to `QByteArray::toDouble()`.
+ *
+ * @note Text shouldn't contain leading or trailing white space.
+ */
+bool parseNumber(const char* begin, const char* end, double& value);
+
+#endif // NUMBERPARSER_H
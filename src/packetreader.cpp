@@ -0,0 +1,292 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtDebug>
+#include <string.h>
+
+#include "packetreader.h"
+
+// COBS delimiter
+#define COBS_END  (0x00)
+// SLIP special characters
+#define SLIP_END     (0xC0)
+#define SLIP_ESC     (0xDB)
+#define SLIP_ESC_END (0xDC)
+#define SLIP_ESC_ESC (0xDD)
+
+PacketReader::PacketReader(QIODevice* device, QObject* parent) :
+    AbstractReader(device, parent)
+{
+    paused = false;
+
+    _numChannels = _settingsWidget.numOfChannels();
+    encoding = _settingsWidget.encoding();
+    compression = _settingsWidget.compression();
+    connect(&_settingsWidget, &PacketReaderSettings::numOfChannelsChanged,
+            this, &PacketReader::onNumOfChannelsChanged);
+    connect(&_settingsWidget, &PacketReaderSettings::encodingChanged,
+            this, &PacketReader::onEncodingChanged);
+    connect(&_settingsWidget, &PacketReaderSettings::compressionChanged,
+            this, &PacketReader::onCompressionChanged);
+
+    // initial number format selection
+    onNumberFormatChanged(_settingsWidget.numberFormat());
+    connect(&_settingsWidget, &PacketReaderSettings::numberFormatChanged,
+            this, &PacketReader::onNumberFormatChanged);
+    connect(&_settingsWidget, &PacketReaderSettings::endiannessChanged,
+            this, &PacketReader::updateDecoder);
+    connect(&_settingsWidget, &PacketReaderSettings::fractionBitsChanged,
+            this, &PacketReader::updateDecoder);
+}
+
+QWidget* PacketReader::settingsWidget()
+{
+    return &_settingsWidget;
+}
+
+void PacketReader::enable(bool enabled)
+{
+    // device may have been restarted, wait for a keyframe
+    if (enabled) varintDecoder.reset();
+    AbstractReader::enable(enabled);
+}
+
+unsigned PacketReader::numChannels() const
+{
+    return _numChannels;
+}
+
+NumberFormat PacketReader::sampleFormat() const
+{
+    // varints may not fit any fixed size type, they are stored as double
+    return compression == PacketCompression_None ? _sampleFormat : NumberFormat_INVALID;
+}
+
+void PacketReader::onNumberFormatChanged(NumberFormat numberFormat)
+{
+    _sampleFormat = numberFormat;
+    updateDecoder();
+    updateSampleFormat();
+}
+
+void PacketReader::updateDecoder()
+{
+    decoder = SampleDecoder(_sampleFormat, _settingsWidget.endianness(), _numChannels,
+                            _settingsWidget.fractionBits());
+    varintDecoder = VarintDecoder(_numChannels,
+                                  compression == PacketCompression_VarintDelta);
+}
+
+void PacketReader::onNumOfChannelsChanged(unsigned value)
+{
+    _numChannels = value;
+    updateDecoder();
+    updateNumChannels();
+    emit numOfChannelsChanged(value);
+}
+
+void PacketReader::onEncodingChanged(PacketEncoding value)
+{
+    encoding = value;
+    window.clear();
+    varintDecoder.reset();
+}
+
+void PacketReader::onCompressionChanged(PacketCompression value)
+{
+    compression = value;
+    window.clear();
+    updateDecoder();
+    updateSampleFormat();
+}
+
+unsigned PacketReader::readData()
+{
+    // append all available bytes to the window
+    unsigned oldSize = window.size();
+    qint64 available = _device->bytesAvailable();
+    window.resize(oldSize + available);
+    qint64 numRead = _device->read(window.data() + oldSize, available);
+    if (numRead < 0) numRead = 0;
+    window.resize(oldSize + numRead);
+
+    char* data = window.data();
+    const unsigned size = window.size();
+    const char delimiter = encoding == PacketEncoding_SLIP ? SLIP_END : COBS_END;
+    const unsigned packageSize = decoder.packageSize();
+    const bool compressed = compression != PacketCompression_None;
+    unsigned pos = 0;           // start of the next (encoded) packet
+    unsigned decodedSize = 0;   // decoded payloads are gathered at start of window
+    unsigned numSamples = 0;    // total samples of compressed payloads
+    packetSizes.clear();
+    while (pos < size)
+    {
+        auto end = (const char*) memchr(data + pos, delimiter, size - pos);
+        if (end == nullptr) break; // wait for rest of the packet
+
+        unsigned packetSize = end - (data + pos);
+        if (packetSize > 0) // skip empty packets, i.e. consecutive delimiters
+        {
+            int n = encoding == PacketEncoding_SLIP ?
+                decodeSlip(data + pos, packetSize, data + decodedSize) :
+                decodeCobs(data + pos, packetSize, data + decodedSize);
+
+            if (n < 0)
+            {
+                qCritical() << "Malformed packet, dropped" << packetSize << "bytes.";
+                varintDecoder.reset();
+            }
+            else if (compressed)
+            {
+                int ns = varintDecoder.accept(data + decodedSize, n);
+                if (ns < 0)
+                {
+                    qCritical() << "Malformed varint packet, dropped" << n << "bytes.";
+                }
+                else if (ns > 0) // else waiting for a keyframe
+                {
+                    packetSizes.push_back(n);
+                    decodedSize += n;
+                    numSamples += ns;
+                }
+            }
+            else if (n == 0 || n % packageSize != 0)
+            {
+                qCritical() <<
+                    QString("Packet size (%1) is not multiple of %2 (package size)!") \
+                    .arg(n).arg(packageSize);
+            }
+            else
+            {
+                decodedSize += n;
+            }
+        }
+        pos += packetSize + 1;
+    }
+
+    if (compressed)
+    {
+        // running state has to be updated even if paused
+        if (numSamples)
+        {
+            SamplePack samples = packPool.take(numSamples, _numChannels);
+            const char* payload = window.constData();
+            unsigned start = 0;
+            for (unsigned packetSize : packetSizes)
+            {
+                start += varintDecoder.decode(payload, packetSize, samples, start);
+                payload += packetSize;
+            }
+            if (!paused)
+            {
+                stamp(samples);
+                feedOut(samples);
+            }
+            packPool.recycle(std::move(samples));
+        }
+    }
+    else
+    {
+        // decode all packets at once
+        unsigned numPackages = decodedSize / packageSize;
+        if (numPackages && !paused)
+        {
+            SamplePack samples = packPool.take(numPackages * decoder.packageSamples(), _numChannels);
+            decoder.decode(window.constData(), numPackages, samples, 0);
+            stamp(samples);
+            feedOut(samples);
+            packPool.recycle(std::move(samples));
+        }
+    }
+
+    // keep the incomplete packet
+    window.remove(0, pos);
+    if ((unsigned) window.size() > MAX_PACKET_SIZE)
+    {
+        qCritical() << "No packet delimiter in" << window.size() << "bytes, dropped.";
+        window.clear();
+        varintDecoder.reset();
+    }
+
+    return numRead;
+}
+
+int PacketReader::decodeCobs(const char* in, unsigned size, char* out)
+{
+    // each block is a code byte followed by `code - 1` data bytes, a
+    // zero is implied after each block except the last one and blocks
+    // of maximum length (0xFF)
+    unsigned i = 0;
+    unsigned o = 0;
+    while (i < size)
+    {
+        unsigned code = (unsigned char) in[i++];
+        unsigned len = code - 1;
+        if (code == COBS_END || i + len > size) return -1;
+
+        memmove(out + o, in + i, len);
+        o += len;
+        i += len;
+        if (code != 0xFF && i < size) out[o++] = 0;
+    }
+    return o;
+}
+
+int PacketReader::decodeSlip(const char* in, unsigned size, char* out)
+{
+    unsigned i = 0;
+    unsigned o = 0;
+    while (i < size)
+    {
+        // copy the run of bytes until next escape at once
+        auto esc = (const char*) memchr(in + i, SLIP_ESC, size - i);
+        unsigned run = (esc == nullptr ? in + size : esc) - (in + i);
+        memmove(out + o, in + i, run);
+        o += run;
+        i += run;
+        if (esc == nullptr) break;
+
+        if (i + 1 >= size) return -1; // escape at the end
+        unsigned char c = in[i + 1];
+        if (c == SLIP_ESC_END)
+        {
+            out[o++] = (char) SLIP_END;
+        }
+        else if (c == SLIP_ESC_ESC)
+        {
+            out[o++] = (char) SLIP_ESC;
+        }
+        else
+        {
+            return -1;
+        }
+        i += 2;
+    }
+    return o;
+}
+
+void PacketReader::saveSettings(QSettings* settings)
+{
+    _settingsWidget.saveSettings(settings);
+}
+
+void PacketReader::loadSettings(QSettings* settings)
+{
+    _settingsWidget.loadSettings(settings);
+}
@@ -0,0 +1,97 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PACKETREADER_H
+#define PACKETREADER_H
+
+#include <QSettings>
+
+#include "abstractreader.h"
+#include "packetreadersettings.h"
+#include "sampledecoder.h"
+#include "varintdecoder.h"
+
+/**
+ * Reads byte stuffed (COBS or SLIP encoded) packets of samples.
+ *
+ * Each packet is terminated by a delimiter byte that can't appear
+ * inside the encoded packet, so synchronization is recovered at the
+ * next delimiter after any corruption. Decoded payload of a packet
+ * contains one or more sets of interleaved channel samples.
+ *
+ * Payloads can also be compressed as varints, see `VarintDecoder`.
+ * In delta mode a malformed packet breaks the running sums of the
+ * channels, samples are dropped until the next keyframe.
+ */
+class PacketReader : public AbstractReader
+{
+    Q_OBJECT
+public:
+    /// Packets longer than this are dropped while waiting for a delimiter
+    static const unsigned MAX_PACKET_SIZE = 65536;
+
+    explicit PacketReader(QIODevice* device, QObject *parent = 0);
+    QWidget* settingsWidget();
+    void enable(bool enabled = true) override;
+    unsigned numChannels() const;
+    NumberFormat sampleFormat() const override;
+    /// Stores settings into a `QSettings`
+    void saveSettings(QSettings* settings);
+    /// Loads settings from a `QSettings`.
+    void loadSettings(QSettings* settings);
+
+private:
+    PacketReaderSettings _settingsWidget;
+    unsigned _numChannels;
+    NumberFormat _sampleFormat;
+    PacketEncoding encoding;
+    PacketCompression compression;
+
+    /// decodes samples in currently selected format
+    SampleDecoder decoder;
+    /// decodes compressed payloads, keeps running state of channels
+    VarintDecoder varintDecoder;
+    /// Sizes of the compressed payloads gathered in `window`
+    std::vector<unsigned> packetSizes;
+    /// Bytes read from device. Packets are decoded in place, decoded
+    /// payloads are moved to the start of the window so that all
+    /// packets of a read can be decoded as a single block.
+    QByteArray window;
+
+    unsigned readData() override;
+
+    /// Decodes a COBS packet (without the delimiter) of `size` bytes
+    /// at `in` into `out`. `out` can be same as or before `in`.
+    /// @return decoded size or `-1` if packet is malformed
+    static int decodeCobs(const char* in, unsigned size, char* out);
+    /// Decodes a SLIP packet (without the END byte) of `size` bytes
+    /// at `in` into `out`. `out` can be same as or before `in`.
+    /// @return decoded size or `-1` if packet is malformed
+    static int decodeSlip(const char* in, unsigned size, char* out);
+
+private slots:
+    void onNumberFormatChanged(NumberFormat numberFormat);
+    void onNumOfChannelsChanged(unsigned value);
+    void onEncodingChanged(PacketEncoding value);
+    void onCompressionChanged(PacketCompression value);
+    /// Re-creates the `decoder` for current settings
+    void updateDecoder();
+};
+
+#endif // PACKETREADER_H
@@ -0,0 +1,191 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "packetreadersettings.h"
+#include "ui_packetreadersettings.h"
+
+#include "utils.h"
+#include "defines.h"
+#include "setting_defines.h"
+
+PacketReaderSettings::PacketReaderSettings(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::PacketReaderSettings)
+{
+    ui->setupUi(this);
+
+    ui->spNumOfChannels->setMaximum(MAX_NUM_CHANNELS);
+
+    // Note: if directly connected we get a runtime warning on incompatible signal arguments
+    connect(ui->spNumOfChannels, SELECT<int>::OVERLOAD_OF(&QSpinBox::valueChanged),
+            [this](int value)
+            {
+                emit numOfChannelsChanged(value);
+            });
+
+    connect(ui->cbEncoding, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged),
+            [this](int)
+            {
+                emit encodingChanged(encoding());
+            });
+
+    connect(ui->cbCompression, SELECT<int>::OVERLOAD_OF(&QComboBox::currentIndexChanged),
+            [this](int)
+            {
+                updateFormatEnabled();
+                emit compressionChanged(compression());
+            });
+
+    connect(ui->nfBox, SIGNAL(selectionChanged(NumberFormat)),
+            this, SIGNAL(numberFormatChanged(NumberFormat)));
+
+    connect(ui->endiBox, SIGNAL(selectionChanged(Endianness)),
+            this, SIGNAL(endiannessChanged(Endianness)));
+
+    connect(ui->nfBox, SIGNAL(fractionBitsChanged(unsigned)),
+            this, SIGNAL(fractionBitsChanged(unsigned)));
+}
+
+PacketReaderSettings::~PacketReaderSettings()
+{
+    delete ui;
+}
+
+unsigned PacketReaderSettings::numOfChannels()
+{
+    return ui->spNumOfChannels->value();
+}
+
+PacketEncoding PacketReaderSettings::encoding()
+{
+    return ui->cbEncoding->currentIndex() == 1 ?
+        PacketEncoding_SLIP : PacketEncoding_COBS;
+}
+
+PacketCompression PacketReaderSettings::compression()
+{
+    switch (ui->cbCompression->currentIndex())
+    {
+        case 1:
+            return PacketCompression_Varint;
+        case 2:
+            return PacketCompression_VarintDelta;
+        default:
+            return PacketCompression_None;
+    }
+}
+
+void PacketReaderSettings::updateFormatEnabled()
+{
+    bool uncompressed = compression() == PacketCompression_None;
+    ui->nfBox->setEnabled(uncompressed);
+    ui->endiBox->setEnabled(uncompressed);
+}
+
+NumberFormat PacketReaderSettings::numberFormat()
+{
+    return ui->nfBox->currentSelection();
+}
+
+Endianness PacketReaderSettings::endianness()
+{
+    return ui->endiBox->currentSelection();
+}
+
+unsigned PacketReaderSettings::fractionBits()
+{
+    return ui->nfBox->fractionBits();
+}
+
+void PacketReaderSettings::saveSettings(QSettings* settings)
+{
+    settings->beginGroup(SettingGroup_Packet);
+    settings->setValue(SG_Packet_NumOfChannels, numOfChannels());
+    settings->setValue(SG_Packet_Encoding,
+                       encoding() == PacketEncoding_SLIP ? "slip" : "cobs");
+    const char* compressionStr[] = {"none", "varint", "varintdelta"};
+    settings->setValue(SG_Packet_Compression, compressionStr[compression()]);
+    settings->setValue(SG_Packet_NumberFormat, numberFormatToStr(numberFormat()));
+    settings->setValue(SG_Packet_Endianness,
+                       endianness() == LittleEndian ? "little" : "big");
+    settings->setValue(SG_Packet_FractionBits, fractionBits());
+    settings->endGroup();
+}
+
+void PacketReaderSettings::loadSettings(QSettings* settings)
+{
+    settings->beginGroup(SettingGroup_Packet);
+
+    // load number of channels
+    ui->spNumOfChannels->setValue(
+        settings->value(SG_Packet_NumOfChannels, numOfChannels()).toInt());
+
+    // load encoding
+    QString encodingSetting =
+        settings->value(SG_Packet_Encoding, QString()).toString();
+    if (encodingSetting == "cobs")
+    {
+        ui->cbEncoding->setCurrentIndex(0);
+    }
+    else if (encodingSetting == "slip")
+    {
+        ui->cbEncoding->setCurrentIndex(1);
+    } // else don't change
+
+    // load compression
+    QString compressionSetting =
+        settings->value(SG_Packet_Compression, QString()).toString();
+    if (compressionSetting == "none")
+    {
+        ui->cbCompression->setCurrentIndex(0);
+    }
+    else if (compressionSetting == "varint")
+    {
+        ui->cbCompression->setCurrentIndex(1);
+    }
+    else if (compressionSetting == "varintdelta")
+    {
+        ui->cbCompression->setCurrentIndex(2);
+    } // else don't change
+
+    // load number format
+    NumberFormat nfSetting =
+        strToNumberFormat(settings->value(SG_Packet_NumberFormat,
+                                          QString()).toString());
+    if (nfSetting == NumberFormat_INVALID) nfSetting = numberFormat();
+    ui->nfBox->setSelection(nfSetting);
+
+    // load endianness
+    QString endiannessSetting =
+        settings->value(SG_Packet_Endianness, QString()).toString();
+    if (endiannessSetting == "little")
+    {
+        ui->endiBox->setSelection(LittleEndian);
+    }
+    else if (endiannessSetting == "big")
+    {
+        ui->endiBox->setSelection(BigEndian);
+    } // else don't change
+
+    // load fraction bits
+    ui->nfBox->setFractionBits(
+        settings->value(SG_Packet_FractionBits, fractionBits()).toUInt());
+
+    settings->endGroup();
+}
@@ -0,0 +1,84 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PACKETREADERSETTINGS_H
+#define PACKETREADERSETTINGS_H
+
+#include <QWidget>
+#include <QSettings>
+
+#include "numberformatbox.h"
+#include "endiannessbox.h"
+
+/// Byte stuffing method that is used to delimit packets
+enum PacketEncoding
+{
+    PacketEncoding_COBS,        ///< Consistent Overhead Byte Stuffing, `0x00` delimited
+    PacketEncoding_SLIP         ///< RFC 1055, `0xC0` delimited
+};
+
+/// Compression of the packet payloads
+enum PacketCompression
+{
+    PacketCompression_None,       ///< samples in selected number format
+    PacketCompression_Varint,     ///< zigzag encoded varints
+    PacketCompression_VarintDelta ///< zigzag encoded varint deltas, with keyframes
+};
+
+namespace Ui {
+class PacketReaderSettings;
+}
+
+class PacketReaderSettings : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PacketReaderSettings(QWidget *parent = 0);
+    ~PacketReaderSettings();
+
+    unsigned numOfChannels();
+    PacketEncoding encoding();
+    PacketCompression compression();
+    NumberFormat numberFormat();
+    Endianness endianness();
+    /// Number of fraction bits for fixed point number formats
+    unsigned fractionBits();
+
+    /// Stores settings into a `QSettings`
+    void saveSettings(QSettings* settings);
+    /// Loads settings from a `QSettings`.
+    void loadSettings(QSettings* settings);
+
+signals:
+    void numOfChannelsChanged(unsigned);
+    void encodingChanged(PacketEncoding);
+    void compressionChanged(PacketCompression);
+    void numberFormatChanged(NumberFormat);
+    void endiannessChanged(Endianness);
+    void fractionBitsChanged(unsigned);
+
+private:
+    Ui::PacketReaderSettings *ui;
+
+    /// Number format selection is only used without compression
+    void updateFormatEnabled();
+};
+
+#endif // PACKETREADERSETTINGS_H
@@ -131,6 +131,18 @@ void Plot::setXAxis(double xMin, double xMax)
     onXScaleChanged();
 }
 
+void Plot::followXLimits(double xMin, double xMax)
+{
+    _xMin = xMin;
+    _xMax = xMax;
+
+    // don't interfere while user is zoomed in
+    if (zoomer.zoomRectIndex() == 0)
+    {
+        zoomer.setXLimits(xMin, xMax, false);
+    }
+}
+
 void Plot::resetAxes()
 {
     // reset y axis
@@ -63,6 +63,9 @@ public slots:
     void darkBackground(bool enabled = true);
     void setYAxis(bool autoScaled, double yMin = 0, double yMax = 1);
     void setXAxis(double xMin, double xMax);
+    /// Updates X limits without un-zooming or replotting. Used for
+    /// following the X data that is provided by the source.
+    void followXLimits(double xMin, double xMax);
     void setSymbols(ShowSymbols shown);
 
     /**
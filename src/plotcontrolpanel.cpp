@@ -136,6 +136,13 @@ PlotControlPanel::PlotControlPanel(QWidget *parent) :
     connect(ui->spPlotWidth, SIGNAL(valueChanged(int)),
             this, SLOT(onPlotWidthChanged()));
 
+    connect(ui->cbHistory, &QCheckBox::toggled,
+            this, &PlotControlPanel::historyChanged);
+    connect(ui->cbHistory, &QCheckBox::toggled,
+            ui->cbHistoryMemory, &QWidget::setEnabled);
+    connect(ui->cbHistoryMemory, &QCheckBox::toggled,
+            this, &PlotControlPanel::historyInMemoryChanged);
+
     // init scale range preset list
     for (int nbits = 8; nbits <= 24; nbits++) // signed binary formats
     {
@@ -379,6 +386,16 @@ double PlotControlPanel::plotWidth() const
     return value;
 }
 
+bool PlotControlPanel::history() const
+{
+    return ui->cbHistory->isChecked();
+}
+
+bool PlotControlPanel::historyInMemory() const
+{
+    return ui->cbHistoryMemory->isChecked();
+}
+
 void PlotControlPanel::onPlotWidthChanged()
 {
     emit plotWidthChanged(plotWidth());
@@ -453,6 +470,8 @@ void PlotControlPanel::saveSettings(QSettings* settings)
     settings->setValue(SG_Plot_AutoScale, autoScale());
     settings->setValue(SG_Plot_YMax, yMax());
     settings->setValue(SG_Plot_YMin, yMin());
+    settings->setValue(SG_Plot_History, history());
+    settings->setValue(SG_Plot_HistoryInMemory, historyInMemory());
     settings->endGroup();
 }
 
@@ -471,5 +490,9 @@ void PlotControlPanel::loadSettings(QSettings* settings)
         settings->value(SG_Plot_AutoScale, autoScale()).toBool());
     ui->spYmax->setValue(settings->value(SG_Plot_YMax, yMax()).toDouble());
     ui->spYmin->setValue(settings->value(SG_Plot_YMin, yMin()).toDouble());
+    ui->cbHistory->setChecked(
+        settings->value(SG_Plot_History, history()).toBool());
+    ui->cbHistoryMemory->setChecked(
+        settings->value(SG_Plot_HistoryInMemory, historyInMemory()).toBool());
     settings->endGroup();
 }
@@ -49,6 +49,10 @@ public:
     double xMin() const;
     /// Returns the plot width adjusted for x axis scaling.
     double plotWidth() const;
+    /// Returns true if history is enabled
+    bool history() const;
+    /// Returns true if history should be kept in memory
+    bool historyInMemory() const;
 
     void setChannelInfoModel(ChannelInfoModel* model);
 
@@ -62,6 +66,8 @@ signals:
     void yScaleChanged(bool autoScaled, double yMin = 0, double yMax = 1);
     void xScaleChanged(bool asIndex, double xMin = 0, double xMax = 1);
     void plotWidthChanged(double width);
+    void historyChanged(bool enabled);
+    void historyInMemoryChanged(bool enabled);
 
 private:
     Ui::PlotControlPanel *ui;
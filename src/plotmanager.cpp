@@ -26,6 +26,18 @@
 #include "utils.h"
 #include "setting_defines.h"
 
+/// Returns the X buffer to plot for a channel, includes the history if it's enabled
+static const XFrameBuffer* plotX(const StreamChannel* ch)
+{
+    return ch->xHistory() != nullptr ? ch->xHistory() : ch->xData();
+}
+
+/// Returns the data buffer to plot for a channel, includes the history if it's enabled
+static const FrameBuffer* plotY(const StreamChannel* ch)
+{
+    return ch->yHistory() != nullptr ? ch->yHistory() : ch->yData();
+}
+
 PlotManager::PlotManager(QWidget* plotArea, PlotMenu* menu,
                          const Stream* stream, QObject* parent) :
     QObject(parent)
@@ -47,12 +59,14 @@ PlotManager::PlotManager(QWidget* plotArea, PlotMenu* menu,
             });
 
     connect(stream, &Stream::numChannelsChanged, this, &PlotManager::onNumChannelsChanged);
-    connect(stream, &Stream::dataAdded, this, &PlotManager::replot);
+    connect(stream, &Stream::dataAdded, this, &PlotManager::onDataAdded);
+    connect(stream, &Stream::buffersChanged, this, &PlotManager::onBuffersChanged);
 
     // add initial curves if any?
     for (unsigned int i = 0; i < stream->numChannels(); i++)
     {
-        addCurve(stream->channel(i)->name(), stream->channel(i)->xData(), stream->channel(i)->yData());
+        auto ch = stream->channel(i);
+        addCurve(ch->name(), plotX(ch), plotY(ch));
     }
 }
 
@@ -69,7 +83,7 @@ PlotManager::PlotManager(QWidget* plotArea, PlotMenu* menu,
 
     for (unsigned ci = 0; ci < snapshot->numChannels(); ci++)
     {
-        addCurve(snapshot->channelName(ci), snapshot->xData[ci], snapshot->yData[ci]);
+        addCurve(snapshot->channelName(ci), snapshot->xData, snapshot->yData[ci]);
     }
 
     connect(infoModel, &QAbstractItemModel::dataChanged,
@@ -90,6 +104,7 @@ void PlotManager::construct(QWidget* plotArea, PlotMenu* menu)
     isDemoShown = false;
     _numOfSamples = 1;
     _plotWidth = 1;
+    showingHistory = false;
     showSymbols = Plot::ShowSymbolsAuto;
     emptyPlot = NULL;
 
@@ -148,7 +163,8 @@ void PlotManager::onNumChannelsChanged(unsigned value)
         // add new channels
         for (unsigned int i = oldNum; i < numOfChannels; i++)
         {
-            addCurve(_stream->channel(i)->name(), _stream->channel(i)->xData(), _stream->channel(i)->yData());
+            auto ch = _stream->channel(i);
+            addCurve(ch->name(), plotX(ch), plotY(ch));
         }
     }
     else if(numOfChannels < oldNum)
@@ -436,6 +452,43 @@ void PlotManager::replot()
     }
 }
 
+void PlotManager::onDataAdded()
+{
+    // X axis follows the data if it's provided by the source or
+    // history is growing
+    if (_stream->hasX() || _stream->hasHistory())
+    {
+        auto xLim = plotX(_stream->channel(0))->limits();
+        for (auto plot : plotWidgets)
+        {
+            plot->followXLimits(xLim.start, xLim.end);
+        }
+    }
+
+    replot();
+}
+
+void PlotManager::onBuffersChanged()
+{
+    // number of curves may not be updated yet if channels are being changed
+    unsigned num = std::min(numOfCurves(), _stream->numChannels());
+    for (unsigned ci = 0; ci < num; ci++)
+    {
+        FrameBufferSeries* series = static_cast<FrameBufferSeries*>(curves[ci]->data());
+        series->setX(plotX(_stream->channel(ci)));
+        series->setY(plotY(_stream->channel(ci)));
+    }
+
+    // restore X limits after history is disabled
+    if (showingHistory && !_stream->hasHistory())
+    {
+        setXAxis(_xAxisAsIndex, _xMin, _xMax);
+    }
+    showingHistory = _stream->hasHistory();
+
+    replot();
+}
+
 void PlotManager::showGrid(bool show)
 {
     for (auto plot : plotWidgets)
@@ -515,7 +568,7 @@ void PlotManager::setXAxis(bool asIndex, double xMin, double xMax)
     for (auto curve : curves)
     {
         FrameBufferSeries* series = static_cast<FrameBufferSeries*>(curve->data());
-        series->setX(_stream->channel(ci)->xData());
+        series->setX(plotX(_stream->channel(ci)));
         ci++;
     }
     for (auto plot : plotWidgets)
@@ -93,6 +93,7 @@ private:
     double _xMax;
     unsigned _numOfSamples;
     double _plotWidth;
+    bool showingHistory;         ///< curves include stream history
     Plot::ShowSymbols showSymbols;
 
     /// Common constructor
@@ -117,6 +118,8 @@ private slots:
     void setSymbols(Plot::ShowSymbols shown);
 
     void onNumChannelsChanged(unsigned value);
+    void onDataAdded();
+    void onBuffersChanged();
     void onChannelInfoChanged(const QModelIndex & topLeft,
                               const QModelIndex & bottomRight,
                               const QVector<int> & roles = QVector<int> ());
@@ -34,22 +34,10 @@ ReadOnlyBuffer::ReadOnlyBuffer(const FrameBuffer* source, unsigned start, unsign
     Q_ASSERT(start + n <= source->size());
 
     _size = n;
-    data = new double[_size];
-
-    for (unsigned i = 0; i < n; i++)
-    {
-        data[i] = source->sample(start + i);
-    }
-
-    /// if not exact copy of source re-calculate limits
-    if (start == 0 && n == source->size())
-    {
-        _limits = source->limits();
-    }
-    else
-    {
-        updateLimits();
-    }
+    _data = new double[_size];
+    source->copyRange(start, n, _data);
+
+    limTree.setData(_data, _size);
 }
 
 ReadOnlyBuffer::ReadOnlyBuffer(const double* source, unsigned ssize)
@@ -57,14 +45,14 @@ ReadOnlyBuffer::ReadOnlyBuffer(const double* source, unsigned ssize)
     Q_ASSERT(source != nullptr && ssize);
 
     _size = ssize;
-    data = new double[_size];
-    memcpy(data, source, sizeof(double) * ssize);
-    updateLimits();
+    _data = new double[_size];
+    memcpy(_data, source, sizeof(double) * ssize);
+    limTree.setData(_data, _size);
 }
 
 ReadOnlyBuffer::~ReadOnlyBuffer()
 {
-    delete[] data;
+    delete[] _data;
 }
 
 unsigned ReadOnlyBuffer::size() const
@@ -74,30 +62,26 @@ unsigned ReadOnlyBuffer::size() const
 
 double ReadOnlyBuffer::sample(unsigned i) const
 {
-    return data[i];
+    return _data[i];
 }
 
 Range ReadOnlyBuffer::limits() const
 {
-    return _limits;
+    return limTree.limits();
+}
+
+Range ReadOnlyBuffer::limits(unsigned start, unsigned n) const
+{
+    return limTree.limits(start, n);
+}
+
+void ReadOnlyBuffer::copyRange(unsigned start, unsigned n, double* out) const
+{
+    Q_ASSERT(start + n <= _size);
+    memcpy(out, _data + start, sizeof(double) * n);
 }
 
-void ReadOnlyBuffer::updateLimits()
+const double* ReadOnlyBuffer::data() const
 {
-    Q_ASSERT(_size);
-
-    _limits.start = data[0];
-    _limits.end = data[0];
-
-    for (unsigned i = 0; i < _size; i++)
-    {
-        if (data[i] > _limits.end)
-        {
-            _limits.end = data[i];
-        }
-        else if (data[i] < _limits.start)
-        {
-            _limits.start = data[i];
-        }
-    }
+    return _data;
 }
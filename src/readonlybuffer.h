@@ -21,6 +21,7 @@
 #define READONLYBUFFER_H
 
 #include "framebuffer.h"
+#include "limitstree.h"
 
 /// A read only frame buffer used for storing snapshot data. Main advantage of
 /// this compared to `RingBuffer` is that reading data should be somewhat
@@ -49,14 +50,16 @@ public:
     virtual unsigned size() const;
     virtual double sample(unsigned i) const;
     virtual Range limits() const;
+    virtual Range limits(unsigned start, unsigned n) const;
+    virtual void copyRange(unsigned start, unsigned n, double* out) const;
 
-private:
-    double* data;    ///< data storage
-    unsigned _size;  ///< data size
-    Range _limits;   ///< limits cache
+    /// Returns the data array for direct access.
+    const double* data() const;
 
-    // TODO: duplicate with `RingBuffer`
-    void updateLimits(); ///< Updates limits cache
+private:
+    double* _data;              ///< data storage
+    unsigned _size;             ///< data size
+    LimitsTree<double> limTree; ///< limits of the data
 };
 
 #endif // READONLYBUFFER_H
@@ -314,6 +314,10 @@ bool RecordPanel::startRecording(QString fileName)
     if (ui->cbHeader->isChecked())
     {
         channelNames = _stream->infoModel()->channelNames();
+        if (_stream->hasX())
+        {
+            channelNames.prepend(tr("device time"));
+        }
     }
 
     if (recorder.startRecording(fileName, getSeparator(), channelNames, currentTimestampOption()))
@@ -18,155 +18,206 @@
 */
 
 #include <QtGlobal>
+#include <algorithm>
+#include <limits>
 
 #include "ringbuffer.h"
 
-RingBuffer::RingBuffer(unsigned n)
+/// Converts a sample to storage type. Integer values are clamped to
+/// the limits of `T`, `NaN` is stored as 0.
+template <typename T>
+static inline T toStorage(double value)
+{
+    if (!std::numeric_limits<T>::is_integer)
+    {
+        return T(value);
+    }
+    else if (value >= std::numeric_limits<T>::max())
+    {
+        return std::numeric_limits<T>::max();
+    }
+    else if (value <= std::numeric_limits<T>::lowest())
+    {
+        return std::numeric_limits<T>::lowest();
+    }
+    else if (value != value) // NaN
+    {
+        return 0;
+    }
+    return T(value);
+}
+
+template <typename T>
+RingBufferOf<T>::RingBufferOf(unsigned n)
 {
     _size = n;
-    data = new double[_size]();
+    data = new T[_size]();
     headIndex = 0;
 
-    limInvalid = false;
-    limCache = {0, 0};
+    limTree.setData(data, _size);
 }
 
-RingBuffer::~RingBuffer()
+template <typename T>
+RingBufferOf<T>::~RingBufferOf()
 {
     delete[] data;
 }
 
-unsigned RingBuffer::size() const
+template <typename T>
+unsigned RingBufferOf<T>::size() const
 {
     return _size;
 }
 
-double RingBuffer::sample(unsigned i) const
+template <typename T>
+double RingBufferOf<T>::sample(unsigned i) const
 {
     unsigned index = headIndex + i;
     if (index >= _size) index -= _size;
     return data[index];
 }
 
-Range RingBuffer::limits() const
+template <typename T>
+Range RingBufferOf<T>::limits() const
 {
-    if (limInvalid) updateLimits();
-    return limCache;
+    return limTree.limits();
 }
 
-void RingBuffer::resize(unsigned n)
+template <typename T>
+Range RingBufferOf<T>::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= _size);
+
+    unsigned index = headIndex + start;
+    if (index >= _size) index -= _size;
+
+    if (index + n <= _size) // range doesn't wrap around
+    {
+        return limTree.limits(index, n);
+    }
+
+    unsigned x = _size - index; // number of samples until the end of array
+    Range a = limTree.limits(index, x);
+    Range b = limTree.limits(0, n - x);
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+template <typename T>
+void RingBufferOf<T>::spans(SpanOf<T>& first, SpanOf<T>& second) const
+{
+    first = {data + headIndex, _size - headIndex};
+    second = {data, headIndex};
+}
+
+template <typename T>
+void RingBufferOf<T>::copyRange(unsigned start, unsigned n, double* out) const
+{
+    copyTo(start, n, out);
+}
+
+template <typename T>
+template <typename O>
+void RingBufferOf<T>::copyTo(unsigned start, unsigned n, O* out) const
+{
+    Q_ASSERT(start + n <= _size);
+
+    unsigned index = headIndex + start;
+    if (index >= _size) index -= _size;
+
+    unsigned x = _size - index; // number of samples until the end of array
+    if (n <= x)
+    {
+        std::copy(data + index, data + index + n, out);
+    }
+    else
+    {
+        std::copy(data + index, data + _size, out);
+        std::copy(data, data + (n - x), out + x);
+    }
+}
+
+template <typename T>
+void RingBufferOf<T>::store(T* dst, const double* samples, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+    {
+        dst[i] = toStorage<T>(samples[i]);
+    }
+}
+
+template <typename T>
+void RingBufferOf<T>::resize(unsigned n)
 {
     Q_ASSERT(n != _size);
 
     int offset = (int) n - (int) _size;
     if (offset == 0) return;
 
-    double* newData = new double[n];
-
-    // move data to new array
-    int fill_start = offset > 0 ? offset : 0;
+    T* newData = new T[n];
 
-    for (int i = fill_start; i < int(n); i++)
+    if (offset > 0) // fill the beginning of the new data with 0
     {
-        newData[i] = sample(i - offset);
+        std::fill(newData, newData + offset, T(0));
+        copyTo(0, _size, newData + offset);
     }
-
-    // fill the beginning of the new data
-    if (fill_start > 0)
+    else // keep the end values
     {
-        for (int i = 0; i < fill_start; i++)
-        {
-            newData[i] = 0;
-        }
+        copyTo(-offset, n, newData);
     }
 
     // data is ready, clean up and re-point
-    delete data;
+    delete[] data;
     data = newData;
     headIndex = 0;
     _size = n;
 
-    // invalidate bounding rectangle
-    limInvalid = true;
+    limTree.setData(data, _size);
 }
 
-void RingBuffer::addSamples(double* samples, unsigned n)
+template <typename T>
+void RingBufferOf<T>::addSamples(double* samples, unsigned n)
 {
-    unsigned shift = n;
-    if (shift < _size)
-    {
-        unsigned x = _size - headIndex; // distance of `head` to end
-
-        if (shift <= x) // there is enough room at the end of array
-        {
-            for (unsigned i = 0; i < shift; i++)
-            {
-                data[i+headIndex] = samples[i];
-            }
-
-            if (shift == x) // we used all the room at the end
-            {
-                headIndex = 0;
-            }
-            else
-            {
-                headIndex += shift;
-            }
-        }
-        else // there isn't enough room
-        {
-            for (unsigned i = 0; i < x; i++) // fill the end part
-            {
-                data[i+headIndex] = samples[i];
-            }
-            for (unsigned i = 0; i < (shift-x); i++) // continue from the beginning
-            {
-                data[i] = samples[i+x];
-            }
-            headIndex = shift-x;
-        }
-    }
-    else // number of new samples equal or bigger than current size (doesn't fit)
+    if (n >= _size) // number of new samples equal or bigger than current size (doesn't fit)
     {
-        int x = shift - _size;
-        for (unsigned i = 0; i < _size; i++)
-        {
-            data[i] = samples[i+x];
-        }
+        store(data, samples + (n - _size), _size);
         headIndex = 0;
+        limTree.update(0, _size);
+        return;
     }
 
-    // invalidate cache
-    limInvalid = true;
-}
-
-void RingBuffer::clear()
-{
-    for (unsigned i=0; i < _size; i++)
+    unsigned x = _size - headIndex; // distance of `head` to end
+    if (n <= x) // there is enough room at the end of array
     {
-        data[i] = 0.;
+        store(data + headIndex, samples, n);
+        limTree.update(headIndex, n);
+
+        headIndex += n;
+        if (headIndex == _size) headIndex = 0; // we used all the room at the end
     }
+    else // there isn't enough room, continue from the beginning
+    {
+        store(data + headIndex, samples, x);
+        store(data, samples + x, n - x);
+        limTree.update(headIndex, x);
+        limTree.update(0, n - x);
 
-    limCache = {0, 0};
-    limInvalid = false;
+        headIndex = n - x;
+    }
 }
 
-void RingBuffer::updateLimits() const
+template <typename T>
+void RingBufferOf<T>::clear()
 {
-    limCache.start = data[0];
-    limCache.end = data[0];
-
-    for (unsigned i = 0; i < _size; i++)
-    {
-        if (data[i] > limCache.end)
-        {
-            limCache.end = data[i];
-        }
-        else if (data[i] < limCache.start)
-        {
-            limCache.start = data[i];
-        }
-    }
-
-    limInvalid = false;
+    std::fill(data, data + _size, T(0));
+    limTree.update(0, _size);
 }
+
+// sample types that are used for storage, see `Stream`
+template class RingBufferOf<double>;
+template class RingBufferOf<float>;
+template class RingBufferOf<qint8>;
+template class RingBufferOf<quint8>;
+template class RingBufferOf<qint16>;
+template class RingBufferOf<quint16>;
+template class RingBufferOf<qint32>;
+template class RingBufferOf<quint32>;
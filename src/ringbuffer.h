@@ -21,29 +21,58 @@
 #define RINGBUFFER_H
 
 #include "framebuffer.h"
+#include "limitstree.h"
 
-/// A fast buffer implementation for storing data.
-class RingBuffer : public WFrameBuffer
+/**
+ * A fast buffer implementation for storing data.
+ *
+ * Samples are stored as `T` and converted to `double` when they are
+ * read. Storing samples in their original (smaller) type saves
+ * memory. When adding samples, values that don't fit in `T` are
+ * clamped to its limits and fractions are dropped.
+ */
+template <typename T>
+class RingBufferOf : public WFrameBuffer
 {
 public:
-    RingBuffer(unsigned n);
-    ~RingBuffer();
+    RingBufferOf(unsigned n);
+    ~RingBufferOf();
 
     virtual unsigned size() const;
     virtual double sample(unsigned i) const;
     virtual Range limits() const;
+    virtual Range limits(unsigned start, unsigned n) const;
     virtual void resize(unsigned n);
     virtual void addSamples(double* samples, unsigned n);
     virtual void clear();
+    virtual void copyRange(unsigned start, unsigned n, double* out) const;
+
+    /**
+     * Returns the contents of the buffer as 2 contiguous arrays. Data
+     * starts at `first` and continues at `second`. `second` is empty
+     * if the data doesn't wrap around the end of the storage.
+     *
+     * @note Spans are invalidated when buffer is resized.
+     */
+    void spans(SpanOf<T>& first, SpanOf<T>& second) const;
+
+    /// Converts and copies `n` samples to `dst`, this is how samples
+    /// are stored in the buffer.
+    static void store(T* dst, const double* samples, unsigned n);
 
 private:
     unsigned _size;            ///< size of `data`
-    double* data;              ///< storage
+    T* data;                   ///< storage
     unsigned headIndex;        ///< indicates the actual `0` index of the ring buffer
 
-    mutable bool limInvalid;   ///< Indicates that limits needs to be re-calculated
-    mutable Range limCache;    ///< Cache for limits()
-    void updateLimits() const; ///< Updates limits cache
+    LimitsTree<T> limTree;     ///< keeps limits updated as data is added
+
+    /// Copies `n` samples starting from index `start` to `out`
+    /// converting them to `O`.
+    template <typename O>
+    void copyTo(unsigned start, unsigned n, O* out) const;
 };
 
+typedef RingBufferOf<double> RingBuffer;
+
 #endif
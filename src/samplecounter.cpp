@@ -17,22 +17,31 @@
   along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <QDateTime>
 #include "samplecounter.h"
+#include "capturetime.h"
 
 SampleCounter::SampleCounter()
 {
-    prevTimeMs = QDateTime::currentMSecsSinceEpoch();
+    prevTimeMs = captureTime() / 1000000;
     count = 0;
+    _latency = -1;
 }
 
-#include <QtDebug>
+qint64 SampleCounter::latency() const
+{
+    return _latency;
+}
 
 void SampleCounter::feedIn(const SamplePack& data)
 {
     count += data.numSamples();
+    if (data.hasTimestamp())
+    {
+        _latency = captureTime() - data.timestamp();
+    }
 
-    qint64 current = QDateTime::currentMSecsSinceEpoch();
+    // use capture time of the pack if it's stamped
+    qint64 current = (data.hasTimestamp() ? data.timestamp() : captureTime()) / 1000000;
     auto diff = current - prevTimeMs;
     if (diff > 1000) // 1sec
     {
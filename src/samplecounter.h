@@ -31,6 +31,10 @@ class SampleCounter : public QObject, public Sink
 public:
     SampleCounter();
 
+    /// Time from the capture of the newest sample until it is counted, in
+    /// nanoseconds. `-1` if unknown.
+    qint64 latency() const;
+
 protected:
     // implementations for `Sink`
     virtual void feedIn(const SamplePack& data);
@@ -42,6 +46,7 @@ signals:
 private:
     qint64 prevTimeMs;
     unsigned count;
+    qint64 _latency;
 };
 
 #endif // SAMPLECOUNTER_H
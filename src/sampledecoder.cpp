@@ -0,0 +1,592 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <math.h>
+#include <string.h>
+
+#include "sampledecoder.h"
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+static const bool HOST_BIG_ENDIAN = true;
+#else
+static const bool HOST_BIG_ENDIAN = false;
+#endif
+
+/// Unsigned integer type that has the same size as a sample, used for
+/// byte swapping
+template <unsigned N> struct SwapType;
+template <> struct SwapType<1> {typedef quint8 type;};
+template <> struct SwapType<2> {typedef quint16 type;};
+template <> struct SwapType<4> {typedef quint32 type;};
+template <> struct SwapType<8> {typedef quint64 type;};
+
+/// Loads a value of type `T` from unaligned memory in given byte order
+template <typename T, bool BigEndian>
+static inline T load(const char* src)
+{
+    typedef typename SwapType<sizeof(T)>::type U;
+
+    U raw;
+    memcpy(&raw, src, sizeof(raw));
+    if (sizeof(T) > 1 && BigEndian != HOST_BIG_ENDIAN) raw = qbswap(raw);
+
+    T value;
+    memcpy(&value, &raw, sizeof(value));
+    return value;
+}
+
+static inline float bitsToFloat(quint32 bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*
+ * Sample types. Each has a `SIZE` in bytes and a `read()` function
+ * that converts a sample to double.
+ */
+
+/// Types that are converted with a simple cast
+template <typename T>
+struct Plain
+{
+    static const unsigned SIZE = sizeof(T);
+
+    template <bool BigEndian>
+    static inline double read(const char* src, double scale)
+    {
+        Q_UNUSED(scale);
+        return double(load<T, BigEndian>(src));
+    }
+};
+
+/// 3 bytes integer
+template <bool Signed>
+struct Int24
+{
+    static const unsigned SIZE = 3;
+
+    template <bool BigEndian>
+    static inline double read(const char* src, double scale)
+    {
+        Q_UNUSED(scale);
+        const uchar* b = reinterpret_cast<const uchar*>(src);
+        quint32 value = BigEndian ?
+            (quint32(b[0]) << 16) | (quint32(b[1]) << 8) | b[2] :
+            (quint32(b[2]) << 16) | (quint32(b[1]) << 8) | b[0];
+        if (Signed)
+        {
+            // sign extend
+            return double(qint32(value ^ 0x800000) - 0x800000);
+        }
+        return double(value);
+    }
+};
+
+/// IEEE 754 half precision float
+struct Half
+{
+    static const unsigned SIZE = 2;
+
+    template <bool BigEndian>
+    static inline double read(const char* src, double scale)
+    {
+        Q_UNUSED(scale);
+        quint16 h = load<quint16, BigEndian>(src);
+        quint32 sign = quint32(h & 0x8000) << 16;
+        quint32 exp = (h >> 10) & 0x1F;
+        quint32 mant = h & 0x3FF;
+
+        if (exp == 0x1F) // inf or nan
+        {
+            return bitsToFloat(sign | 0x7F800000 | (mant << 13));
+        }
+        else if (exp != 0) // normal
+        {
+            return bitsToFloat(sign | ((exp + 112) << 23) | (mant << 13));
+        }
+        else // zero or subnormal, mant * 2^-24
+        {
+            double value = mant / 16777216.;
+            return sign ? -value : value;
+        }
+    }
+};
+
+/// Brain floating point, upper 2 bytes of a float
+struct BFloat16
+{
+    static const unsigned SIZE = 2;
+
+    template <bool BigEndian>
+    static inline double read(const char* src, double scale)
+    {
+        Q_UNUSED(scale);
+        return bitsToFloat(quint32(load<quint16, BigEndian>(src)) << 16);
+    }
+};
+
+/// Signed fixed point number, scaled by `2^-fractionBits`
+template <typename T>
+struct Fixed
+{
+    static const unsigned SIZE = sizeof(T);
+
+    template <bool BigEndian>
+    static inline double read(const char* src, double scale)
+    {
+        return double(load<T, BigEndian>(src)) * scale;
+    }
+};
+
+/**
+ * Decoding kernel. `NC` is the number of channels if it's known at
+ * compile time, `0` otherwise.
+ *
+ * Channels are de-interleaved one at a time so that writes are
+ * contiguous and the inner loop is simple enough to be vectorized by
+ * the compiler (byte swap and conversion included).
+ */
+template <typename F, bool BigEndian, unsigned NC>
+static void decodeAs(const char* src, unsigned n, SamplePack& out, unsigned start,
+                     double scale)
+{
+    const unsigned nc = NC ? NC : out.numChannels();
+    const unsigned stride = nc * F::SIZE;
+
+    Q_ASSERT(out.numChannels() == nc);
+    Q_ASSERT(start + n <= out.numSamples());
+
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        const char* s = src + ci * F::SIZE;
+        double* d = out.data(ci) + start;
+        for (unsigned i = 0; i < n; i++)
+        {
+            d[i] = F::template read<BigEndian>(s + i * stride, scale);
+        }
+    }
+}
+
+typedef void (*DecodeFunc)(const char*, unsigned, SamplePack&, unsigned, double);
+
+template <typename F, bool BigEndian>
+static DecodeFunc decoderFor(unsigned nc)
+{
+    switch (nc)
+    {
+        case 1: return &decodeAs<F, BigEndian, 1>;
+        case 2: return &decodeAs<F, BigEndian, 2>;
+        case 3: return &decodeAs<F, BigEndian, 3>;
+        case 4: return &decodeAs<F, BigEndian, 4>;
+        default: return &decodeAs<F, BigEndian, 0>;
+    }
+}
+
+/**
+ * Field decoding kernel, decodes a single channel of a mixed type
+ * package. `src` points to the field in the first package and
+ * `stride` is the package size.
+ */
+template <typename F, bool BigEndian>
+static void decodeFieldAs(const char* src, unsigned stride, unsigned n, double* dst,
+                          double scale, unsigned shift, unsigned width)
+{
+    Q_UNUSED(shift);
+    Q_UNUSED(width);
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        dst[i] = F::template read<BigEndian>(src + i * stride, scale);
+    }
+}
+
+/**
+ * Bit field decoding kernel. Field is `width` bits starting from bit
+ * `shift` of an integer of type `T`, it's sign extended if `Signed`.
+ */
+template <typename T, bool BigEndian, bool Signed>
+static void decodeBitFieldAs(const char* src, unsigned stride, unsigned n, double* dst,
+                             double scale, unsigned shift, unsigned width)
+{
+    Q_UNUSED(scale);
+
+    const T mask = T((quint64(1) << width) - 1);
+    const qint64 sign = qint64(1) << (width - 1);
+    for (unsigned i = 0; i < n; i++)
+    {
+        T value = T(load<T, BigEndian>(src + i * stride) >> shift) & mask;
+        if (Signed)
+        {
+            dst[i] = double((qint64(value) ^ sign) - sign);
+        }
+        else
+        {
+            dst[i] = double(value);
+        }
+    }
+}
+
+typedef void (*FieldFunc)(const char*, unsigned, unsigned, double*, double,
+                          unsigned, unsigned);
+
+/// Returns the bit field decoding kernel for an integer of `size` bytes
+template <bool BigEndian>
+static FieldFunc bitFieldDecoderFor(unsigned size, bool isSigned)
+{
+    switch (size)
+    {
+        case 1:
+            return isSigned ? &decodeBitFieldAs<quint8, BigEndian, true> :
+                &decodeBitFieldAs<quint8, BigEndian, false>;
+        case 2:
+            return isSigned ? &decodeBitFieldAs<quint16, BigEndian, true> :
+                &decodeBitFieldAs<quint16, BigEndian, false>;
+        case 4:
+            return isSigned ? &decodeBitFieldAs<quint32, BigEndian, true> :
+                &decodeBitFieldAs<quint32, BigEndian, false>;
+    }
+
+    Q_ASSERT(false);
+    return &decodeBitFieldAs<quint8, BigEndian, false>;
+}
+
+static constexpr unsigned gcd(unsigned a, unsigned b)
+{
+    return b ? gcd(b, a % b) : a;
+}
+
+/// Bit packed unsigned integers of `Bits` width
+template <unsigned Bits>
+struct Packed
+{
+    /// Number of samples in the smallest group that ends on a byte boundary
+    static const unsigned GROUP_SAMPLES = 8 / gcd(Bits, 8);
+    /// Size of a group in bytes
+    static const unsigned GROUP_SIZE = GROUP_SAMPLES * Bits / 8;
+    static const quint64 MASK = (quint64(1) << Bits) - 1;
+
+    /// Loads a group as an integer so that samples can be extracted
+    /// with shifts
+    template <bool BigEndian>
+    static inline quint64 loadGroup(const uchar* src)
+    {
+        quint64 group = 0;
+        for (unsigned i = 0; i < GROUP_SIZE; i++)
+        {
+            group = (group << 8) | src[BigEndian ? i : GROUP_SIZE - 1 - i];
+        }
+        return group;
+    }
+
+    /// Returns the `k`th sample of a group
+    template <bool BigEndian>
+    static inline double sample(quint64 group, unsigned k)
+    {
+        unsigned shift = BigEndian ? (GROUP_SAMPLES - 1 - k) * Bits : k * Bits;
+        return double((group >> shift) & MASK);
+    }
+};
+
+/**
+ * Bit packed decoding kernel, `n` is the number of sample sets.
+ *
+ * With a single channel samples are unpacked a whole group at a time
+ * into contiguous memory. Otherwise channels are de-interleaved one at
+ * a time like `decodeAs()`.
+ */
+template <unsigned Bits, bool BigEndian>
+static void decodePackedAs(const char* src, unsigned n, SamplePack& out, unsigned start,
+                           double scale)
+{
+    typedef Packed<Bits> P;
+    Q_UNUSED(scale);
+
+    const unsigned nc = out.numChannels();
+    const uchar* s = reinterpret_cast<const uchar*>(src);
+
+    Q_ASSERT((n * nc) % P::GROUP_SAMPLES == 0);
+    Q_ASSERT(start + n <= out.numSamples());
+
+    if (nc == 1)
+    {
+        double* d = out.data(0) + start;
+        for (unsigned g = 0; g < n / P::GROUP_SAMPLES; g++)
+        {
+            quint64 group = P::template loadGroup<BigEndian>(s + g * P::GROUP_SIZE);
+            for (unsigned k = 0; k < P::GROUP_SAMPLES; k++)
+            {
+                d[g * P::GROUP_SAMPLES + k] = P::template sample<BigEndian>(group, k);
+            }
+        }
+        return;
+    }
+
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        double* d = out.data(ci) + start;
+        for (unsigned i = 0; i < n; i++)
+        {
+            unsigned j = i * nc + ci; // index in the bit stream
+            quint64 group = P::template loadGroup<BigEndian>(
+                s + (j / P::GROUP_SAMPLES) * P::GROUP_SIZE);
+            d[i] = P::template sample<BigEndian>(group, j % P::GROUP_SAMPLES);
+        }
+    }
+}
+
+template <unsigned Bits>
+static DecodeFunc packedDecoderFor(Endianness endianness)
+{
+    if (endianness == BigEndian)
+    {
+        return &decodePackedAs<Bits, true>;
+    }
+    else
+    {
+        return &decodePackedAs<Bits, false>;
+    }
+}
+
+/// Selects the package decoding kernel
+struct PackageKernel
+{
+    typedef DecodeFunc Func;
+
+    template <typename F>
+    static Func make(Endianness endianness, unsigned nc)
+    {
+        if (endianness == BigEndian)
+        {
+            return decoderFor<F, true>(nc);
+        }
+        else
+        {
+            return decoderFor<F, false>(nc);
+        }
+    }
+};
+
+/// Selects the field decoding kernel
+struct FieldKernel
+{
+    typedef FieldFunc Func;
+
+    template <typename F>
+    static Func make(Endianness endianness)
+    {
+        if (endianness == BigEndian)
+        {
+            return &decodeFieldAs<F, true>;
+        }
+        else
+        {
+            return &decodeFieldAs<F, false>;
+        }
+    }
+};
+
+/// Returns the `Kernel` function specialized for the sample type of `format`
+template <typename Kernel, typename... Args>
+static typename Kernel::Func kernelFor(NumberFormat format, Args... args)
+{
+    switch(format)
+    {
+        case NumberFormat_uint8:
+            return Kernel::template make<Plain<quint8>>(args...);
+        case NumberFormat_int8:
+            return Kernel::template make<Plain<qint8>>(args...);
+        case NumberFormat_uint16:
+            return Kernel::template make<Plain<quint16>>(args...);
+        case NumberFormat_int16:
+            return Kernel::template make<Plain<qint16>>(args...);
+        case NumberFormat_uint32:
+            return Kernel::template make<Plain<quint32>>(args...);
+        case NumberFormat_int32:
+            return Kernel::template make<Plain<qint32>>(args...);
+        case NumberFormat_float:
+            return Kernel::template make<Plain<float>>(args...);
+        case NumberFormat_uint64:
+            return Kernel::template make<Plain<quint64>>(args...);
+        case NumberFormat_int64:
+            return Kernel::template make<Plain<qint64>>(args...);
+        case NumberFormat_double:
+            return Kernel::template make<Plain<double>>(args...);
+        case NumberFormat_uint24:
+            return Kernel::template make<Int24<false>>(args...);
+        case NumberFormat_int24:
+            return Kernel::template make<Int24<true>>(args...);
+        case NumberFormat_half:
+            return Kernel::template make<Half>(args...);
+        case NumberFormat_bfloat16:
+            return Kernel::template make<BFloat16>(args...);
+        case NumberFormat_q16:
+            return Kernel::template make<Fixed<qint16>>(args...);
+        case NumberFormat_q32:
+            return Kernel::template make<Fixed<qint32>>(args...);
+        case NumberFormat_uint10:
+        case NumberFormat_uint12:
+        case NumberFormat_uint14:
+            // bit packed formats have their own kernels, see `packedDecoderFor()`
+        case NumberFormat_INVALID:
+            break;
+    }
+
+    Q_ASSERT(false);
+    return Kernel::template make<Plain<quint8>>(args...);
+}
+
+unsigned sampleSize(NumberFormat format)
+{
+    switch(format)
+    {
+        case NumberFormat_uint8:
+        case NumberFormat_int8:
+            return 1;
+        case NumberFormat_uint16:
+        case NumberFormat_int16:
+        case NumberFormat_half:
+        case NumberFormat_bfloat16:
+        case NumberFormat_q16:
+            return 2;
+        case NumberFormat_uint24:
+        case NumberFormat_int24:
+            return 3;
+        case NumberFormat_uint32:
+        case NumberFormat_int32:
+        case NumberFormat_float:
+        case NumberFormat_q32:
+            return 4;
+        case NumberFormat_uint64:
+        case NumberFormat_int64:
+        case NumberFormat_double:
+            return 8;
+        case NumberFormat_uint10:
+        case NumberFormat_uint12:
+        case NumberFormat_uint14:
+            return 2;
+        case NumberFormat_INVALID:
+            break;
+    }
+
+    Q_ASSERT(false);
+    return 1;
+}
+
+unsigned sampleBits(NumberFormat format)
+{
+    switch(format)
+    {
+        case NumberFormat_uint10:
+            return 10;
+        case NumberFormat_uint12:
+            return 12;
+        case NumberFormat_uint14:
+            return 14;
+        default:
+            return sampleSize(format) * 8;
+    }
+}
+
+SampleDecoder::SampleDecoder(NumberFormat format, Endianness endianness,
+                             unsigned nc, unsigned fractionBits)
+{
+    scale = ldexp(1.0, -int(fractionBits));
+
+    unsigned bits = sampleBits(format);
+    if (bits % 8 == 0)
+    {
+        _sampleSize = bits / 8;
+        _packageSize = _sampleSize * nc;
+        _packageSamples = 1;
+        func = kernelFor<PackageKernel>(format, endianness, nc);
+        return;
+    }
+
+    // bit packed, package is extended until it ends on a byte boundary
+    _sampleSize = 0;
+    _packageSamples = 1;
+    while ((_packageSamples * nc * bits) % 8) _packageSamples++;
+    _packageSize = _packageSamples * nc * bits / 8;
+
+    switch (format)
+    {
+        case NumberFormat_uint10:
+            func = packedDecoderFor<10>(endianness);
+            break;
+        case NumberFormat_uint12:
+            func = packedDecoderFor<12>(endianness);
+            break;
+        case NumberFormat_uint14:
+            func = packedDecoderFor<14>(endianness);
+            break;
+        default:
+            Q_ASSERT(false);
+            func = nullptr;
+    }
+}
+
+SampleDecoder::SampleDecoder(const FrameLayout& layout, Endianness endianness,
+                             unsigned fractionBits)
+{
+    Q_ASSERT(!layout.isEmpty());
+
+    _sampleSize = 0;
+    _packageSize = layout.size();
+    _packageSamples = 1;
+    scale = ldexp(1.0, -int(fractionBits));
+    func = nullptr;
+
+    // compile the layout, type and byte order of each field are
+    // resolved here once instead of for every package
+    for (auto& field : layout.fields())
+    {
+        Endianness e = field.defaultEndianness ? endianness : field.endianness;
+        FieldFunc f;
+        if (field.bitWidth)
+        {
+            unsigned size = ::sampleSize(field.format);
+            f = e == BigEndian ?
+                bitFieldDecoderFor<true>(size, field.bitSigned) :
+                bitFieldDecoderFor<false>(size, field.bitSigned);
+        }
+        else
+        {
+            f = kernelFor<FieldKernel>(field.format, e);
+        }
+        plan.push_back({f, field.offset, field.bitShift, field.bitWidth});
+    }
+}
+
+void SampleDecoder::decodePlan(const char* src, unsigned n, SamplePack& out,
+                               unsigned start, unsigned firstChannel) const
+{
+    Q_ASSERT(firstChannel + plan.size() <= out.numChannels());
+    Q_ASSERT(start + n <= out.numSamples());
+
+    for (unsigned ci = 0; ci < plan.size(); ci++)
+    {
+        plan[ci].func(src + plan[ci].offset, _packageSize, n,
+                      out.data(firstChannel + ci) + start, scale,
+                      plan[ci].shift, plan[ci].width);
+    }
+}
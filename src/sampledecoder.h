@@ -0,0 +1,152 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAMPLEDECODER_H
+#define SAMPLEDECODER_H
+
+#include <vector>
+
+#include "numberformat.h"
+#include "endiannessbox.h"
+#include "samplepack.h"
+#include "framelayout.h"
+
+/// Returns the size of a single sample of `format` in bytes, rounded
+/// up for bit packed formats
+unsigned sampleSize(NumberFormat format);
+
+/// Returns the number of bits of a single sample of `format`, it's
+/// not a multiple of 8 for bit packed formats
+unsigned sampleBits(NumberFormat format);
+
+/**
+ * Decodes packages of binary samples into a `SamplePack`.
+ *
+ * Decoding function is selected at construction, specialized at
+ * compile time for the sample type and byte order, and also for the
+ * number of channels if it's small. Decoder should be re-created when
+ * settings change and then used for all incoming data.
+ *
+ * Packages of mixed type samples are decoded according to a
+ * `FrameLayout`, which is compiled into a plan of field decoders,
+ * each one specialized for the type and byte order of its field.
+ *
+ * Bit packed formats (`NumberFormat_uint12` etc.) are stored back to
+ * back without padding. Their package is the smallest number of
+ * sample sets that ends on a byte boundary, see `packageSamples()`.
+ * Endianness selects the bit order: little endian starts from the
+ * least significant bit of the first byte, big endian starts from
+ * the most significant bit.
+ */
+class SampleDecoder
+{
+public:
+    /**
+     * @param format sample format
+     * @param endianness byte order of samples
+     * @param nc number of channels
+     * @param fractionBits number of fractional bits, only used for
+     *                     fixed point formats (`NumberFormat_q16`,
+     *                     `NumberFormat_q32`)
+     */
+    explicit SampleDecoder(NumberFormat format = NumberFormat_uint8,
+                           Endianness endianness = LittleEndian,
+                           unsigned nc = 1, unsigned fractionBits = 0);
+
+    /**
+     * @param layout layout of a package, must not be empty
+     * @param endianness byte order of fields that don't specify one
+     * @param fractionBits number of fractional bits of fixed point fields
+     */
+    SampleDecoder(const FrameLayout& layout, Endianness endianness,
+                  unsigned fractionBits = 0);
+
+    /**
+     * Decodes `n` packages from `src` into `out`, starting from sample
+     * index `start` of the pack. A package is made of 1 sample of each
+     * channel, in channel order (`packageSamples()` samples for bit
+     * packed formats).
+     *
+     * @note `src` should contain at least `n * packageSize()` bytes
+     * and `out` should have `nc` channels and at least `start + n *
+     * packageSamples()` samples.
+     */
+    void decode(const char* src, unsigned n, SamplePack& out, unsigned start) const
+    {
+        if (plan.empty())
+        {
+            func(src, n * _packageSamples, out, start, scale);
+        }
+        else
+        {
+            Q_ASSERT(out.numChannels() == plan.size());
+            decodePlan(src, n, out, start, 0);
+        }
+    };
+
+    /**
+     * Same as `decode()` but writes into the channels of `out`
+     * starting from `firstChannel`, so that packages of different
+     * layouts can be decoded into groups of the same pack.
+     *
+     * @note Only for decoders created with a `FrameLayout`.
+     */
+    void decodeGroup(const char* src, unsigned n, SamplePack& out, unsigned start,
+                     unsigned firstChannel) const
+    {
+        Q_ASSERT(!plan.empty());
+        decodePlan(src, n, out, start, firstChannel);
+    };
+
+    /// Size of a single sample in bytes, `0` for mixed type packages
+    /// and bit packed formats
+    unsigned sampleSize() const {return _sampleSize;};
+    /// Size of a package in bytes
+    unsigned packageSize() const {return _packageSize;};
+    /// Number of samples of each channel in a package, it's more than
+    /// 1 only for bit packed formats
+    unsigned packageSamples() const {return _packageSamples;};
+
+private:
+    typedef void (*DecodeFunc)(const char* src, unsigned n, SamplePack& out,
+                               unsigned start, double scale);
+    typedef void (*FieldFunc)(const char* src, unsigned stride, unsigned n,
+                              double* dst, double scale, unsigned shift, unsigned width);
+
+    /// Decodes a single channel of mixed type packages
+    struct FieldDecoder
+    {
+        FieldFunc func;
+        unsigned offset;        ///< offset of the field in package
+        unsigned shift;         ///< first bit of a bit field
+        unsigned width;         ///< width of a bit field, `0` if it's not a bit field
+    };
+
+    DecodeFunc func;
+    std::vector<FieldDecoder> plan; ///< one entry per channel, empty if not mixed
+    double scale;               ///< applied to fixed point samples
+    unsigned _sampleSize;
+    unsigned _packageSize;
+    unsigned _packageSamples;
+
+    void decodePlan(const char* src, unsigned n, SamplePack& out, unsigned start,
+                    unsigned firstChannel) const;
+};
+
+#endif // SAMPLEDECODER_H
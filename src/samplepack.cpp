@@ -28,14 +28,20 @@ SamplePack::SamplePack(unsigned ns, unsigned nc, bool x)
 
     _numSamples = ns;
     _numChannels = nc;
+    _hasX = x;
+    _timestamp = -1;
+    _sampleInterval = 0;
 
-    _yData = new double[_numSamples * _numChannels]();
+    _capacity = _numSamples * _numChannels;
+    _yData = new double[_capacity]();
     if (x)
     {
-        _xData = new double[_numSamples]();
+        _xCapacity = _numSamples;
+        _xData = new double[_xCapacity]();
     }
     else
     {
+        _xCapacity = 0;
         _xData = nullptr;
     }
 }
@@ -47,20 +53,83 @@ SamplePack::SamplePack(const SamplePack& other) :
     if (hasX())
         memcpy(xData(), other.xData(), dataSize);
     memcpy(_yData, other._yData, dataSize * numChannels());
+    copyTimestamp(other);
+}
+
+SamplePack::SamplePack(SamplePack&& other)
+{
+    _numSamples = other._numSamples;
+    _numChannels = other._numChannels;
+    _hasX = other._hasX;
+    _capacity = other._capacity;
+    _xCapacity = other._xCapacity;
+    _yData = other._yData;
+    _xData = other._xData;
+    copyTimestamp(other);
+
+    other._numSamples = other._numChannels = 0;
+    other._hasX = false;
+    other._capacity = other._xCapacity = 0;
+    other._yData = other._xData = nullptr;
+}
+
+SamplePack& SamplePack::operator=(SamplePack&& other)
+{
+    if (this != &other)
+    {
+        delete[] _yData;
+        delete[] _xData;
+
+        _numSamples = other._numSamples;
+        _numChannels = other._numChannels;
+        _hasX = other._hasX;
+        _capacity = other._capacity;
+        _xCapacity = other._xCapacity;
+        _yData = other._yData;
+        _xData = other._xData;
+        copyTimestamp(other);
+
+        other._numSamples = other._numChannels = 0;
+        other._hasX = false;
+        other._capacity = other._xCapacity = 0;
+        other._yData = other._xData = nullptr;
+    }
+    return *this;
 }
 
 SamplePack::~SamplePack()
 {
     delete[] _yData;
-    if (_xData != nullptr)
+    delete[] _xData;
+}
+
+void SamplePack::reshape(unsigned ns, unsigned nc, bool x)
+{
+    Q_ASSERT(ns > 0 && nc > 0);
+
+    _numSamples = ns;
+    _numChannels = nc;
+    _hasX = x;
+    _timestamp = -1;
+    _sampleInterval = 0;
+
+    if (ns * nc > _capacity)
+    {
+        delete[] _yData;
+        _capacity = ns * nc;
+        _yData = new double[_capacity];
+    }
+    if (x && ns > _xCapacity)
     {
         delete[] _xData;
+        _xCapacity = ns;
+        _xData = new double[_xCapacity];
     }
 }
 
 bool SamplePack::hasX() const
 {
-    return _xData != nullptr;
+    return _hasX;
 }
 
 unsigned SamplePack::numChannels() const
@@ -75,7 +144,7 @@ unsigned SamplePack::numSamples() const
 
 double* SamplePack::xData() const
 {
-    Q_ASSERT(_xData != nullptr);
+    Q_ASSERT(_hasX);
 
     return _xData;
 }
@@ -96,3 +165,37 @@ double* SamplePack::data(unsigned channel)
 {
     return const_cast<double*>(static_cast<const SamplePack&>(*this).data(channel));
 }
+
+void SamplePack::setTimestamp(int64_t time, double interval)
+{
+    _timestamp = time;
+    _sampleInterval = interval;
+}
+
+void SamplePack::copyTimestamp(const SamplePack& other)
+{
+    _timestamp = other._timestamp;
+    _sampleInterval = other._sampleInterval;
+}
+
+bool SamplePack::hasTimestamp() const
+{
+    return _timestamp >= 0;
+}
+
+int64_t SamplePack::timestamp() const
+{
+    return _timestamp;
+}
+
+double SamplePack::sampleInterval() const
+{
+    return _sampleInterval;
+}
+
+int64_t SamplePack::sampleTime(unsigned i) const
+{
+    Q_ASSERT(i < _numSamples);
+
+    return _timestamp - int64_t((_numSamples - 1 - i) * _sampleInterval);
+}
@@ -20,6 +20,8 @@
 #ifndef SAMPLEPACK_H
 #define SAMPLEPACK_H
 
+#include <stdint.h>
+
 class SamplePack
 {
 public:
@@ -30,8 +32,22 @@ public:
      */
     SamplePack(unsigned ns, unsigned nc, bool x = false);
     SamplePack(const SamplePack& other);
+    /// Takes the storage of `other`, which is left empty.
+    SamplePack(SamplePack&& other);
+    SamplePack& operator=(SamplePack&& other);
+    SamplePack& operator=(const SamplePack& other) = delete;
     ~SamplePack();
 
+    /**
+     * Changes the dimensions of the pack. Storage is re-allocated
+     * only if new dimensions don't fit, so a pack can be re-used
+     * without allocation.
+     *
+     * @note Contents are not initialized after this call, timestamp
+     * is cleared.
+     */
+    void reshape(unsigned ns, unsigned nc, bool x = false);
+
     bool hasX() const;
     unsigned numChannels() const;
     unsigned numSamples() const;
@@ -41,10 +57,34 @@ public:
     double* xData();
     double* data(unsigned channel);
 
+    /**
+     * Sets the capture time of the pack.
+     *
+     * @param time capture time of the last sample in nanoseconds, see `captureTime()`
+     * @param interval estimated interval between samples in
+     *                 nanoseconds, `0` if unknown
+     */
+    void setTimestamp(int64_t time, double interval);
+    /// Copies capture time of `other`
+    void copyTimestamp(const SamplePack& other);
+    bool hasTimestamp() const;
+    /// Capture time of the last sample, `-1` if unknown
+    int64_t timestamp() const;
+    /// Estimated interval between samples in nanoseconds, `0` if unknown
+    double sampleInterval() const;
+    /// Capture time of sample `i`, interpolated backwards from the
+    /// last sample with `sampleInterval()`
+    int64_t sampleTime(unsigned i) const;
+
 private:
     unsigned _numSamples, _numChannels;
+    bool _hasX;
+    unsigned _capacity;  ///< size of `_yData`
+    unsigned _xCapacity; ///< size of `_xData`
     double* _xData;
     double* _yData;
+    int64_t _timestamp;
+    double _sampleInterval;
 };
 
 #endif // SAMPLEPACK_H
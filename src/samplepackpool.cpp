@@ -0,0 +1,48 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "samplepackpool.h"
+
+SamplePackPool::SamplePackPool()
+{
+    packs.reserve(MAX_PACKS);
+}
+
+SamplePack SamplePackPool::take(unsigned ns, unsigned nc, bool x)
+{
+    if (packs.empty())
+    {
+        return SamplePack(ns, nc, x);
+    }
+
+    // last recycled pack is more likely to be in cache
+    SamplePack pack(std::move(packs.back()));
+    packs.pop_back();
+    pack.reshape(ns, nc, x);
+    return pack;
+}
+
+void SamplePackPool::recycle(SamplePack&& pack)
+{
+    // an empty (moved from) pack has no storage to re-use
+    if (pack.numChannels() > 0 && packs.size() < MAX_PACKS)
+    {
+        packs.push_back(std::move(pack));
+    }
+}
@@ -0,0 +1,58 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAMPLEPACKPOOL_H
+#define SAMPLEPACKPOOL_H
+
+#include <utility>
+#include <vector>
+
+#include "samplepack.h"
+
+/**
+ * Keeps the storage of used `SamplePack`s to be re-used.
+ *
+ * Packs are taken from the pool, filled and fed out, then given back
+ * with `recycle()`. After a few rounds no allocation is made as long
+ * as the packs don't grow.
+ */
+class SamplePackPool
+{
+public:
+    /// Maximum number of packs kept in the pool
+    static const unsigned MAX_PACKS = 8;
+
+    SamplePackPool();
+
+    /**
+     * Returns a pack with given dimensions. Storage of a recycled
+     * pack is used if there is one.
+     *
+     * @note Contents of a recycled pack are not initialized.
+     */
+    SamplePack take(unsigned ns, unsigned nc, bool x = false);
+
+    /// Gives back a pack for re-use, `pack` is left empty
+    void recycle(SamplePack&& pack);
+
+private:
+    std::vector<SamplePack> packs;
+};
+
+#endif // SAMPLEPACKPOOL_H
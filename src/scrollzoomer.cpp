@@ -65,11 +65,11 @@ ScrollZoomer::~ScrollZoomer()
     delete d_hScrollData;
 }
 
-void ScrollZoomer::setXLimits(double min, double max)
+void ScrollZoomer::setXLimits(double min, double max, bool doReplot)
 {
     xMin = min;
     xMax = max;
-    setZoomBase();
+    setZoomBase(doReplot);
 }
 
 void ScrollZoomer::setHViewSize(double size)
@@ -50,7 +50,7 @@ public:
 
     virtual bool eventFilter( QObject *, QEvent * );
 
-    void setXLimits(double min, double max);
+    void setXLimits(double min, double max, bool doReplot = true);
     void setHViewSize(double size);
     virtual void setZoomBase(bool doReplot = true);
     virtual void rescale();
@@ -26,6 +26,7 @@ const char SettingGroup_DataFormat[] = "DataFormat";
 const char SettingGroup_Binary[] = "DataFormat_Binary";
 const char SettingGroup_ASCII[] = "DataFormat_ASCII";
 const char SettingGroup_CustomFrame[] = "DataFormat_CustomFrame";
+const char SettingGroup_Packet[] = "DataFormat_Packet";
 const char SettingGroup_Channels[] = "Channels";
 const char SettingGroup_Plot[] = "Plot";
 const char SettingGroup_Commands[] = "Commands";
@@ -56,11 +57,17 @@ const char SG_DataFormat_Format[] = "format";
 const char SG_Binary_NumOfChannels[] = "numOfChannels";
 const char SG_Binary_NumberFormat[] = "numberFormat";
 const char SG_Binary_Endianness[] = "endianness";
+const char SG_Binary_FractionBits[] = "fractionBits";
+const char SG_Binary_ClockChannel[] = "clockChannel";
+const char SG_Binary_ClockTickRate[] = "clockTickRate";
+const char SG_Binary_ClockWrapBits[] = "clockWrapBits";
 
 // ascii reader keys
 const char SG_ASCII_NumOfChannels[] = "numOfChannels";
 const char SG_ASCII_Delimiter[] = "delimiter";
 const char SG_ASCII_CustomDelimiter[] = "customDelimiter";
+const char SG_ASCII_Labeled[] = "labeled";
+const char SG_ASCII_KeepMissing[] = "keepMissing";
 
 // framed reader keys
 const char SG_CustomFrame_NumOfChannels[] = "numOfChannels";
@@ -69,9 +76,29 @@ const char SG_CustomFrame_FixedSize[] = "fixedSize";
 const char SG_CustomFrame_FrameSize[] = "frameSize";
 const char SG_CustomFrame_NumberFormat[] = "numberFormat";
 const char SG_CustomFrame_Endianness[] = "endianness";
+const char SG_CustomFrame_FractionBits[] = "fractionBits";
+const char SG_CustomFrame_Layout[] = "layout";
+const char SG_CustomFrame_Messages[] = "messages";
 const char SG_CustomFrame_Checksum[] = "checksum";
+const char SG_CustomFrame_ChecksumType[] = "checksumType";
+const char SG_CustomFrame_ChecksumInit[] = "checksumInit";
+const char SG_CustomFrame_ChecksumXorOut[] = "checksumXorOut";
+const char SG_CustomFrame_ChecksumReflect[] = "checksumReflect";
+const char SG_CustomFrame_ChecksumHeader[] = "checksumHeader";
+const char SG_CustomFrame_MaxLatency[] = "maxLatency";
+const char SG_CustomFrame_ClockChannel[] = "clockChannel";
+const char SG_CustomFrame_ClockTickRate[] = "clockTickRate";
+const char SG_CustomFrame_ClockWrapBits[] = "clockWrapBits";
 const char SG_CustomFrame_DebugMode[] = "debugMode";
 
+// packet reader keys
+const char SG_Packet_NumOfChannels[] = "numOfChannels";
+const char SG_Packet_Encoding[] = "encoding";
+const char SG_Packet_Compression[] = "compression";
+const char SG_Packet_NumberFormat[] = "numberFormat";
+const char SG_Packet_Endianness[] = "endianness";
+const char SG_Packet_FractionBits[] = "fractionBits";
+
 // channel info keys
 const char SG_Channels_Channel[] = "channel";
 const char SG_Channels_Name[] = "name";
@@ -91,6 +118,8 @@ const char SG_Plot_XMin[] = "xMin";
 const char SG_Plot_AutoScale[] = "autoScale";
 const char SG_Plot_YMax[] = "yMax";
 const char SG_Plot_YMin[] = "yMin";
+const char SG_Plot_History[] = "history";
+const char SG_Plot_HistoryInMemory[] = "historyInMemory";
 const char SG_Plot_DarkBackground[] = "darkBackground";
 const char SG_Plot_Grid[] = "grid";
 const char SG_Plot_MinorGrid[] = "minorGrid";
@@ -26,6 +26,7 @@ void Sink::connectFollower(Sink* sink)
 
     followers.append(sink);
     sink->setNumChannels(_numChannels, _hasX);
+    sink->setSampleFormat(_sampleFormat);
 }
 
 void Sink::disconnectFollower(Sink* sink)
@@ -53,6 +54,15 @@ void Sink::setNumChannels(unsigned nc, bool x)
     }
 }
 
+void Sink::setSampleFormat(NumberFormat format)
+{
+    _sampleFormat = format;
+    for (auto sink : followers)
+    {
+        sink->setSampleFormat(format);
+    }
+}
+
 void Sink::setSource(Source* s)
 {
     Q_ASSERT((source == nullptr) != (s == nullptr));
@@ -22,6 +22,7 @@
 
 #include <QList>
 #include "samplepack.h"
+#include "numberformat.h"
 
 class Source;
 
@@ -52,6 +53,12 @@ protected:
     /// this function to update followers.
     virtual void setNumChannels(unsigned nc, bool x);
 
+    /// Is set by connected source. Re-implementations should call
+    /// this function to update followers.
+    ///
+    /// @see Source::sampleFormat()
+    virtual void setSampleFormat(NumberFormat format);
+
     /// Set by the connected source when its connected. When
     /// disconnecting it's set to `nullptr`.
     ///
@@ -68,6 +75,7 @@ private:
     Source* source = nullptr;   ///< source that this sink is connected to
     bool _hasX;
     unsigned _numChannels;
+    NumberFormat _sampleFormat = NumberFormat_INVALID;
 };
 
 #endif // SINK_H
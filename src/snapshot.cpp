@@ -34,6 +34,7 @@ Snapshot::Snapshot(MainWindow* parent, QString name, ChannelInfoModel infoModel,
     _name = name;
     _saved = saved;
 
+    xData = NULL;
     view = NULL;
     mainWindow = parent;
     _showAction.setText(displayName());
@@ -49,6 +50,12 @@ Snapshot::~Snapshot()
     {
         delete view;
     }
+
+    delete xData;
+    for (auto y : yData)
+    {
+        delete y;
+    }
 }
 
 QAction* Snapshot::showAction()
@@ -27,7 +27,7 @@
 #include <QStringList>
 
 #include "channelinfomodel.h"
-#include "readonlybuffer.h"
+#include "framebuffer.h"
 #include "indexbuffer.h"
 
 class SnapshotView;
@@ -42,8 +42,8 @@ public:
     ~Snapshot();
 
     // TODO: yData and xData of snapshot shouldn't be public, preferable should be handled in constructor
-    QVector<IndexBuffer*> xData;
-    QVector<ReadOnlyBuffer*> yData;
+    IndexBuffer* xData; ///< shared by all channels, owned by snapshot
+    QVector<FrameBuffer*> yData;
     QAction* showAction();
     QAction* deleteAction();
 
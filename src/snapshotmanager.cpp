@@ -30,6 +30,7 @@
 
 #include "mainwindow.h"
 #include "snapshotmanager.h"
+#include "readonlybuffer.h"
 
 SnapshotManager::SnapshotManager(MainWindow* mainWindow,
                                  Stream* stream) :
@@ -69,10 +70,10 @@ Snapshot* SnapshotManager::makeSnapshot() const
     QString name = QTime::currentTime().toString("'Snapshot ['HH:mm:ss']'");
     auto snapshot = new Snapshot(_mainWindow, name, *(_stream->infoModel()));
 
+    snapshot->xData = new IndexBuffer(_stream->numSamples());
     for (unsigned ci = 0; ci < _stream->numChannels(); ci++)
     {
-        snapshot->xData.append(new IndexBuffer(_stream->numSamples()));
-        snapshot->yData.append(new ReadOnlyBuffer(_stream->channel(ci)->yData()));
+        snapshot->yData.append(_stream->snapshot(ci));
     }
 
     return snapshot;
@@ -201,9 +202,9 @@ void SnapshotManager::loadSnapshotFromFile(QString fileName)
         _mainWindow, QFileInfo(fileName).baseName(),
         ChannelInfoModel(channelNames), true);
 
+    snapshot->xData = new IndexBuffer(data[0].size());
     for (unsigned ci = 0; ci < numOfChannels; ci++)
     {
-        snapshot->xData.append(new IndexBuffer(data[ci].size()));
         snapshot->yData.append(new ReadOnlyBuffer(data[ci].data(), data[ci].size()));
     }
 
@@ -29,6 +29,11 @@ Source::~Source()
     }
 }
 
+NumberFormat Source::sampleFormat() const
+{
+    return NumberFormat_INVALID;
+}
+
 void Source::connectSink(Sink* sink)
 {
     Q_ASSERT(!sinks.contains(sink));
@@ -42,6 +47,7 @@ void Source::connectSink(Sink* sink)
     sinks.append(sink);
     sink->setSource(this);
     sink->setNumChannels(numChannels(), hasX());
+    sink->setSampleFormat(sampleFormat());
 }
 
 void Source::disconnect(Sink* sink)
@@ -77,3 +83,11 @@ void Source::updateNumChannels() const
         sink->setNumChannels(numChannels(), hasX());
     }
 }
+
+void Source::updateSampleFormat() const
+{
+    for (auto sink : sinks)
+    {
+        sink->setSampleFormat(sampleFormat());
+    }
+}
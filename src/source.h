@@ -37,6 +37,12 @@ public:
     /// Returns number of channels
     virtual unsigned numChannels() const = 0;
 
+    /// Returns the original format of the samples before they are
+    /// converted to `double`. Sinks may use this to store samples in
+    /// a smaller type. `NumberFormat_INVALID` means samples can be
+    /// any `double` value, which is the default.
+    virtual NumberFormat sampleFormat() const;
+
     /// Connects a sink to this source.
     ///
     /// If `Sink` is already connected to a source, it's disconnected first.
@@ -57,6 +63,10 @@ protected:
     /// called when num. channels or hasX changes.
     void updateNumChannels() const;
 
+    /// Updates "sample format" of connected sinks. Must be called
+    /// when `sampleFormat()` changes.
+    void updateSampleFormat() const;
+
 private:
     QList<Sink*> sinks;
 };
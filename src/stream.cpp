@@ -17,13 +17,19 @@
   along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <QtDebug>
+#include <algorithm>
+
 #include "stream.h"
-#include "ringbuffer.h"
+#include "xringbuffer.h"
 #include "indexbuffer.h"
 #include "linindexbuffer.h"
+#include "historyfile.h"
+#include "compressedhistory.h"
 
 Stream::Stream(unsigned nc, bool x, unsigned ns) :
-    _infoModel(nc)
+    _infoModel(nc),
+    gainPack(1, 1)
 {
     _numSamples = ns;
     _paused = false;
@@ -32,12 +38,20 @@ Stream::Stream(unsigned nc, bool x, unsigned ns) :
     xMin = 0;
     xMax = 1;
 
+    _sampleFormat = NumberFormat_INVALID;
+    storageFormat = NumberFormat_INVALID;
+
+    _historyEnabled = false;
+    _historyInMemory = false;
+    history = nullptr;
+    historyX = nullptr;
+    numFilled = 0;
+
     // create xdata buffer
     _hasx = x;
     if (x)
     {
-        // TODO: implement XRingBuffer (binary search)
-        Q_ASSERT(false);
+        xData = new XRingBuffer(ns);
     }
     else
     {
@@ -45,11 +59,18 @@ Stream::Stream(unsigned nc, bool x, unsigned ns) :
     }
 
     // create channels
+    yData = makeYBuffer(nc);
     for (unsigned i = 0; i < nc; i++)
     {
-        auto c = new StreamChannel(i, xData, new RingBuffer(ns), &_infoModel);
+        auto c = new StreamChannel(i, xData, yData->channel(i), &_infoModel);
         channels.append(c);
     }
+
+    // gain and offset changes may require a different storage type
+    connect(&_infoModel, &QAbstractItemModel::dataChanged,
+            this, &Stream::updateStorage);
+    connect(&_infoModel, &QAbstractItemModel::modelReset,
+            this, &Stream::updateStorage);
 }
 
 Stream::~Stream()
@@ -58,6 +79,10 @@ Stream::~Stream()
     {
         delete ch;
     }
+    qDeleteAll(historyY);
+    delete historyX;
+    delete history;
+    delete yData;
     delete xData;
 }
 
@@ -87,6 +112,12 @@ StreamChannel* Stream::channel(unsigned index)
     return const_cast<StreamChannel*>(static_cast<const Stream&>(*this).channel(index));
 }
 
+FrameBuffer* Stream::snapshot(unsigned index)
+{
+    Q_ASSERT(index < numChannels());
+    return yData->snapshot(index);
+}
+
 QVector<const StreamChannel*> Stream::allChannels() const
 {
     QVector<const StreamChannel*> result(numChannels());
@@ -107,6 +138,11 @@ ChannelInfoModel* Stream::infoModel()
     return const_cast<ChannelInfoModel*>(static_cast<const Stream&>(*this).infoModel());
 }
 
+bool Stream::hasHistory() const
+{
+    return history != nullptr;
+}
+
 void Stream::setNumChannels(unsigned nc, bool x)
 {
     unsigned oldNum = numChannels();
@@ -115,9 +151,10 @@ void Stream::setNumChannels(unsigned nc, bool x)
     // adjust the number of channels
     if (nc > oldNum)
     {
+        yData->setNumChannels(nc);
         for (unsigned i = oldNum; i < nc; i++)
         {
-            auto c = new StreamChannel(i, xData, new RingBuffer(_numSamples), &_infoModel);
+            auto c = new StreamChannel(i, xData, yData->channel(i), &_infoModel);
             channels.append(c);
         }
     }
@@ -127,15 +164,17 @@ void Stream::setNumChannels(unsigned nc, bool x)
         {
             delete channels.takeLast();
         }
+        yData->setNumChannels(nc);
     }
 
     // change the xdata
+    XFrameBuffer* oldXData = nullptr;
     if (x != _hasx)
     {
+        oldXData = xData;
         if (x)
         {
-            // TODO: implement XRingBuffer (binary search)
-            Q_ASSERT(false);
+            xData = new XRingBuffer(_numSamples);
         }
         else
         {
@@ -149,6 +188,16 @@ void Stream::setNumChannels(unsigned nc, bool x)
         _hasx = x;
     }
 
+    // history layout depends on number of channels
+    resetHistory();
+
+    // old X buffer isn't referenced by history buffers anymore
+    if (oldXData != nullptr)
+    {
+        delete oldXData;
+        emit buffersChanged();
+    }
+
     if (nc != oldNum)
     {
         _infoModel.setNumOfChannels(nc);
@@ -171,43 +220,101 @@ XFrameBuffer* Stream::makeXBuffer() const
     }
 }
 
-const SamplePack* Stream::applyGainOffset(const SamplePack& pack) const
+MultiRingBuffer* Stream::makeYBuffer(unsigned nc) const
+{
+    switch (storageFormat)
+    {
+        case NumberFormat_uint8:
+            return new MultiRingBufferOf<quint8>(nc, _numSamples);
+        case NumberFormat_uint16:
+            return new MultiRingBufferOf<quint16>(nc, _numSamples);
+        case NumberFormat_uint32:
+            return new MultiRingBufferOf<quint32>(nc, _numSamples);
+        case NumberFormat_int8:
+            return new MultiRingBufferOf<qint8>(nc, _numSamples);
+        case NumberFormat_int16:
+            return new MultiRingBufferOf<qint16>(nc, _numSamples);
+        case NumberFormat_int32:
+            return new MultiRingBufferOf<qint32>(nc, _numSamples);
+        case NumberFormat_uint10:
+        case NumberFormat_uint12:
+        case NumberFormat_uint14:
+            return new MultiRingBufferOf<quint16>(nc, _numSamples);
+        case NumberFormat_uint24:
+            return new MultiRingBufferOf<quint32>(nc, _numSamples);
+        case NumberFormat_int24:
+            return new MultiRingBufferOf<qint32>(nc, _numSamples);
+        case NumberFormat_float:
+        case NumberFormat_half:
+        case NumberFormat_bfloat16:
+        case NumberFormat_q16: // at most 16 significant bits, fits in float
+            return new MultiRingBufferOf<float>(nc, _numSamples);
+        default: // 64 bits types and `NumberFormat_q32`
+            return new MultiRingBufferOf<double>(nc, _numSamples);
+    }
+}
+
+void Stream::setSampleFormat(NumberFormat format)
+{
+    _sampleFormat = format;
+    updateStorage();
+
+    Sink::setSampleFormat(format);
+}
+
+void Stream::updateStorage()
+{
+    NumberFormat format = _infoModel.gainOrOffsetEn() ? NumberFormat_INVALID : _sampleFormat;
+    if (format == storageFormat) return;
+    storageFormat = format;
+
+    // move existing data into a new buffer
+    unsigned nc = numChannels();
+    SamplePack pack(_numSamples, nc);
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        yData->channel(ci)->copyRange(0, _numSamples, pack.data(ci));
+    }
+
+    auto newData = makeYBuffer(nc);
+    newData->addSamples(pack);
+    for (unsigned ci = 0; ci < nc; ci++)
+    {
+        channels[ci]->setY(newData->channel(ci));
+    }
+    delete yData;
+    yData = newData;
+    updateHistoryBuffers();
+
+    emit buffersChanged();
+}
+
+void Stream::applyGainOffset(const SamplePack& pack)
 {
     Q_ASSERT(infoModel()->gainOrOffsetEn());
 
-    SamplePack* mPack = new SamplePack(pack);
     unsigned ns = pack.numSamples();
+    gainPack.reshape(ns, pack.numChannels(), pack.hasX());
+    gainPack.copyTimestamp(pack);
+    if (pack.hasX())
+    {
+        std::copy(pack.xData(), pack.xData() + ns, gainPack.xData());
+    }
 
     for (unsigned ci = 0; ci < numChannels(); ci++)
     {
-        // TODO: we could use some kind of map (int32, int64 would suffice) to speed things up
-        bool gainEn = infoModel()->gainEn(ci);
-        bool offsetEn = infoModel()->offsetEn(ci);
-        if (gainEn || offsetEn)
-        {
-            double* mdata = mPack->data(ci);
+        const double* data = pack.data(ci);
+        double* mdata = gainPack.data(ci);
 
-            double gain = infoModel()->gain(ci);
-            double offset = infoModel()->offset(ci);
+        // disabled gain and offset are the same as 1 and 0
+        double gain = infoModel()->gainEn(ci) ? infoModel()->gain(ci) : 1.;
+        double offset = infoModel()->offsetEn(ci) ? infoModel()->offset(ci) : 0.;
 
-            if (gainEn)
-            {
-                for (unsigned i = 0; i < ns; i++)
-                {
-                    mdata[i] *= gain;
-                }
-            }
-            if (offsetEn)
-            {
-                for (unsigned i = 0; i < ns; i++)
-                {
-                    mdata[i] += offset;
-                }
-            }
+        for (unsigned i = 0; i < ns; i++)
+        {
+            mdata[i] = data[i] * gain + offset;
         }
     }
-
-    return mPack;
 }
 
 void Stream::feedIn(const SamplePack& pack)
@@ -220,26 +327,31 @@ void Stream::feedIn(const SamplePack& pack)
     unsigned ns = pack.numSamples();
     if (_hasx)
     {
-        // TODO: implement XRingBuffer (binary search)
-        Q_ASSERT(false);
-        // static_cast<RingBuffer*>(xData)->addSamples(pack.xData(), ns);
+        static_cast<XRingBuffer*>(xData)->addSamples(pack.xData(), ns);
     }
 
-    // modified pack that gain and offset is applied to
-    const SamplePack* mPack = nullptr;
+    // pack that gain and offset is applied to
+    const SamplePack* mPack = &pack;
     if (infoModel()->gainOrOffsetEn())
-        mPack = applyGainOffset(pack);
+    {
+        applyGainOffset(pack);
+        mPack = &gainPack;
+    }
 
-    for (unsigned ci = 0; ci < numChannels(); ci++)
+    if (history != nullptr)
     {
-        auto buf = static_cast<RingBuffer*>(channels[ci]->yData());
-        double* data = (mPack == nullptr) ? pack.data(ci) : mPack->data(ci);
-        buf->addSamples(data, ns);
+        // move samples that will be overwritten
+        unsigned empty = _numSamples - numFilled;
+        unsigned overwritten = std::min(ns, _numSamples);
+        moveToHistory(empty, overwritten > empty ? overwritten - empty : 0,
+                      mPack, ns > _numSamples ? ns - _numSamples : 0);
     }
+    numFilled = std::min(numFilled + ns, _numSamples);
 
-    Sink::feedIn((mPack == nullptr) ? pack : *mPack);
+    yData->addSamples(*mPack);
+
+    Sink::feedIn(*mPack);
 
-    if (mPack != nullptr) delete mPack;
     emit dataAdded();
 }
 
@@ -250,22 +362,34 @@ void Stream::pause(bool paused)
 
 void Stream::clear()
 {
-    for (auto c : channels)
+    if (_hasx)
     {
-        static_cast<RingBuffer*>(c->yData())->clear();
+        static_cast<XRingBuffer*>(xData)->clear();
+    }
+
+    yData->clear();
+    numFilled = 0;
+    if (history != nullptr)
+    {
+        history->clear();
     }
 }
 
 void Stream::setNumSamples(unsigned value)
 {
     if (value == _numSamples) return;
-    _numSamples = value;
 
-    xData->resize(value);
-    for (auto c : channels)
+    // keep the samples that are dropped from the start
+    unsigned empty = _numSamples - numFilled;
+    if (history != nullptr && value < _numSamples && _numSamples - value > empty)
     {
-        static_cast<RingBuffer*>(c->yData())->resize(value);
+        moveToHistory(empty, _numSamples - value - empty);
     }
+    numFilled = std::min(numFilled, value);
+    _numSamples = value;
+
+    xData->resize(value);
+    yData->resize(value);
 }
 
 void Stream::setXAxis(bool asIndex, double min, double max)
@@ -278,11 +402,117 @@ void Stream::setXAxis(bool asIndex, double min, double max)
     // TODO: assert (UI options for x axis should be disabled)
     if (!hasX())
     {
+        auto oldXData = xData;
         xData = makeXBuffer();
         for (auto c : channels)
         {
             c->setX(xData);
         }
+        updateHistoryBuffers();
+        delete oldXData;
+        emit buffersChanged();
+    }
+}
+
+void Stream::setHistoryEnabled(bool enabled)
+{
+    if (enabled == _historyEnabled) return;
+    _historyEnabled = enabled;
+    resetHistory();
+}
+
+void Stream::setHistoryInMemory(bool enabled)
+{
+    if (enabled == _historyInMemory) return;
+    _historyInMemory = enabled;
+    if (_historyEnabled) resetHistory();
+}
+
+void Stream::resetHistory()
+{
+    bool hadHistory = history != nullptr;
+    delete history;
+    history = nullptr;
+
+    if (_historyEnabled && !_hasx)
+    {
+        if (_historyInMemory)
+        {
+            history = new CompressedHistory(numChannels());
+        }
+        else
+        {
+            auto file = new HistoryFile(numChannels());
+            if (file->isOpen())
+            {
+                history = file;
+            }
+            else
+            {
+                delete file;
+            }
+        }
+    }
+
+    updateHistoryBuffers();
+    if (hadHistory || history != nullptr)
+    {
+        emit buffersChanged();
+    }
+}
+
+void Stream::updateHistoryBuffers()
+{
+    qDeleteAll(historyY);
+    historyY.clear();
+    delete historyX;
+    historyX = nullptr;
+
+    if (history != nullptr)
+    {
+        historyX = new HistoryXBuffer(history, xData);
+        for (unsigned ci = 0; ci < numChannels(); ci++)
+        {
+            historyY.append(new HistoryBuffer(history, ci, yData->channel(ci)));
+        }
+    }
+
+    for (unsigned ci = 0; ci < numChannels(); ci++)
+    {
+        if (history != nullptr)
+        {
+            channels[ci]->setHistory(historyX, historyY[ci]);
+        }
+        else
+        {
+            channels[ci]->setHistory(nullptr, nullptr);
+        }
+    }
+}
+
+void Stream::moveToHistory(unsigned start, unsigned n, const SamplePack* pack, unsigned m)
+{
+    Q_ASSERT(history != nullptr);
+
+    for (unsigned ci = 0; ci < numChannels(); ci++)
+    {
+        history->append(ci, 0, yData->channel(ci), start, n);
+        if (m)
+        {
+            history->append(ci, n, pack->data(ci), m);
+        }
+    }
+    history->commit(n + m);
+
+    if (history->failed())
+    {
+        // older samples are lost, keep the history in memory from now on
+        qCritical() << "History can't be stored in a file anymore, continuing in memory.";
+        delete history;
+        history = new CompressedHistory(numChannels());
+        updateHistoryBuffers();
+        emit buffersChanged();
+        moveToHistory(start, n, pack, m);
     }
 }
 
@@ -30,6 +30,9 @@
 #include "channelinfomodel.h"
 #include "streamchannel.h"
 #include "framebuffer.h"
+#include "multiringbuffer.h"
+#include "history.h"
+#include "historybuffer.h"
 
 /**
  * Main waveform storage class. It consists of channels. Channels are
@@ -60,6 +63,12 @@ public:
     QVector<const StreamChannel*> allChannels() const;
     const ChannelInfoModel* infoModel() const;
     ChannelInfoModel* infoModel();
+    /// Returns true if history is enabled and available
+    bool hasHistory() const;
+    /// Returns a read only copy of a channels data. Copy shares memory
+    /// with the stream buffer, see `MultiRingBuffer::snapshot()`.
+    /// Returned buffer is owned by the caller.
+    FrameBuffer* snapshot(unsigned index);
 
     /// Saves channel information
     void saveSettings(QSettings* settings) const;
@@ -70,6 +79,7 @@ protected:
     // implementations for `Sink`
     virtual void setNumChannels(unsigned nc, bool x);
     virtual void feedIn(const SamplePack& pack);
+    virtual void setSampleFormat(NumberFormat format);
 
 signals:
     void numChannelsChanged(unsigned value);
@@ -77,6 +87,9 @@ signals:
     void channelAdded(const StreamChannel* chan);
     void channelNameChanged(unsigned channel, QString name); // TODO: does it stay?
     void dataAdded(); ///< emitted when data added to channel man.
+    /// Emitted when data buffers of channels are replaced. Buffers
+    /// returned from `StreamChannel::yData()` before this are deleted.
+    void buffersChanged();
 
 public slots:
     /// Change number of samples (buffer size)
@@ -92,12 +105,26 @@ public slots:
     /// Clears buffer data (fills with 0)
     void clear();
 
+    /**
+     * Enables keeping the samples that don't fit into the buffer in
+     * a temporary file. History of channels is accessed with
+     * `StreamChannel::yHistory()`.
+     *
+     * @note History is not available when X is provided by source.
+     */
+    void setHistoryEnabled(bool enabled);
+
+    /// Keep history compressed in memory instead of a temporary
+    /// file. Changing this discards the current history.
+    void setHistoryInMemory(bool enabled);
+
 private:
     unsigned _numSamples;
     bool _paused;
 
     bool _hasx;
     XFrameBuffer* xData;
+    MultiRingBuffer* yData; ///< data of all channels
     QList<StreamChannel*> channels;
 
     ChannelInfoModel _infoModel;
@@ -105,21 +132,65 @@ private:
     bool xAsIndex;
     double xMin, xMax;
 
+    NumberFormat _sampleFormat; ///< sample format of the connected source
+    /// Type of the samples stored in channel buffers. `NumberFormat_INVALID`
+    /// means samples are stored as `double`.
+    NumberFormat storageFormat;
+
+    bool _historyEnabled;
+    bool _historyInMemory;
+    History* history;             ///< `nullptr` when history is not available
+    HistoryXBuffer* historyX;
+    QList<HistoryBuffer*> historyY;
+    /// Number of samples in the buffer that are actually fed, rest
+    /// (at the start) are initial zeros.
+    unsigned numFilled;
+
+    /// Holds the data that gain and offset is applied to, re-used for
+    /// each incoming pack
+    SamplePack gainPack;
+
     /**
-     * Applies gain and offset to given pack.
+     * Applies gain and offset to given pack and writes result to
+     * `gainPack`. Input is copied and transformed in a single pass.
      *
-     * Caller is responsible for deleting returned `SamplePack`.
+     * @note Input pack is shared with other sinks of the source so
+     * it's not modified.
      *
      * @note Should be called only when gain or offset is enabled. Guard with
      * `ChannelInfoModel::gainOrOffsetEn()`.
      *
      * @param pack input data
-     * @return modified data
      */
-    const SamplePack* applyGainOffset(const SamplePack& pack) const;
+    void applyGainOffset(const SamplePack& pack);
 
     /// Returns a new virtual X buffer for settings
     XFrameBuffer* makeXBuffer() const;
+
+    /// Returns a new channel data buffer for `storageFormat`
+    MultiRingBuffer* makeYBuffer(unsigned nc) const;
+
+    /// Re-creates the history (discarding its data) if it's enabled,
+    /// deletes it otherwise.
+    void resetHistory();
+    /// Re-creates history buffers of channels, should be called when
+    /// `xData` or `yData` is replaced.
+    void updateHistoryBuffers();
+    /// Moves `n` fed samples starting from `start` in buffer and
+    /// first `m` samples of `pack` into history.
+    void moveToHistory(unsigned start, unsigned n, const SamplePack* pack = nullptr,
+                       unsigned m = 0);
+
+private slots:
+    /**
+     * Selects the storage type of channel buffers and converts the
+     * existing data if it changes.
+     *
+     * Samples are stored in the source sample format to save
+     * memory. When gain or offset is enabled they are stored as
+     * `double` instead.
+     */
+    void updateStorage();
 };
 
 
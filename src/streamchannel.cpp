@@ -21,28 +21,33 @@
 #include "streamchannel.h"
 
 StreamChannel::StreamChannel(unsigned i, const XFrameBuffer* x,
-              FrameBuffer* y, ChannelInfoModel* info)
+              const FrameBuffer* y, ChannelInfoModel* info)
 {
     _index = i;
     _x = x;
     _y = y;
+    _xh = nullptr;
+    _yh = nullptr;
     _info = info;
 }
 
-StreamChannel::~StreamChannel()
-{
-    delete _y;
-}
-
 unsigned StreamChannel::index() const {return _index;}
 QString StreamChannel::name() const {return _info->name(_index);};
 QColor StreamChannel::color() const {return _info->color(_index);};
 bool StreamChannel::visible() const {return _info->isVisible(_index);};
 const XFrameBuffer* StreamChannel::xData() const {return _x;}
 const FrameBuffer* StreamChannel::yData() const {return _y;}
-FrameBuffer* StreamChannel::yData() {return _y;}
 const ChannelInfoModel* StreamChannel::info() const {return _info;}
 void StreamChannel::setX(const XFrameBuffer* x) {_x = x;};
+void StreamChannel::setY(const FrameBuffer* y) {_y = y;};
+const XFrameBuffer* StreamChannel::xHistory() const {return _xh;}
+const FrameBuffer* StreamChannel::yHistory() const {return _yh;}
+
+void StreamChannel::setHistory(const XFrameBuffer* x, const FrameBuffer* y)
+{
+    _xh = x;
+    _yh = y;
+}
 
 double StreamChannel::findValue(double x) const
 {
@@ -31,24 +31,30 @@ public:
      *
      * @param i index of the channel
      * @param x x axis buffer
-     * @param y data buffer of this channel, takes ownership
+     * @param y data buffer of this channel
      * @param info channel info model
      */
     StreamChannel(unsigned i,
                   const XFrameBuffer* x,
-                  FrameBuffer* y,
+                  const FrameBuffer* y,
                   ChannelInfoModel* info);
-    ~StreamChannel();
 
     unsigned index() const;
     QString name() const;
     QColor color() const;
     bool visible() const;
     const XFrameBuffer* xData() const;
-    FrameBuffer* yData();
     const FrameBuffer* yData() const;
     const ChannelInfoModel* info() const;
     void setX(const XFrameBuffer* x);
+    void setY(const FrameBuffer* y);
+
+    /// Returns X buffer of history, `nullptr` if history isn't enabled
+    const XFrameBuffer* xHistory() const;
+    /// Returns data buffer including the history, `nullptr` if
+    /// history isn't enabled
+    const FrameBuffer* yHistory() const;
+    void setHistory(const XFrameBuffer* x, const FrameBuffer* y);
 
     /**
      * Returns sample value for `x`.
@@ -61,7 +67,9 @@ public:
 private:
     unsigned _index;
     const XFrameBuffer* _x;
-    FrameBuffer* _y;
+    const FrameBuffer* _y;
+    const XFrameBuffer* _xh;
+    const FrameBuffer* _yh;
     ChannelInfoModel* _info;
 };
 
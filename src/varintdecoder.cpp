@@ -0,0 +1,140 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "varintdecoder.h"
+
+VarintDecoder::VarintDecoder(unsigned nc, bool delta) :
+    last(nc, 0), dst(nc, nullptr)
+{
+    Q_ASSERT(nc > 0);
+
+    numChannels = nc;
+    this->delta = delta;
+    _synced = !delta;
+}
+
+void VarintDecoder::reset()
+{
+    _synced = !delta;
+}
+
+bool VarintDecoder::synced() const
+{
+    return _synced;
+}
+
+int VarintDecoder::accept(const char* src, unsigned size)
+{
+    auto p = (const unsigned char*) src;
+    auto end = p + size;
+
+    bool keyframe = false;
+    if (delta)
+    {
+        if (size == 0 || (*p != DELTA_FLAG && *p != KEYFRAME_FLAG))
+        {
+            _synced = false;
+            return -1;
+        }
+        keyframe = *p++ == KEYFRAME_FLAG;
+    }
+
+    // count the last bytes of varints, also check their lengths
+    unsigned numValues = 0;
+    unsigned run = 0;
+    for (; p < end; p++)
+    {
+        if (*p & 0x80)
+        {
+            if (++run >= MAX_VARINT_SIZE) break;
+        }
+        else
+        {
+            numValues++;
+            run = 0;
+        }
+    }
+
+    if (run > 0 || numValues == 0 || numValues % numChannels != 0)
+    {
+        // deltas in this packet are lost
+        if (delta) _synced = false;
+        return -1;
+    }
+
+    if (keyframe) _synced = true;
+    return _synced ? numValues / numChannels : 0;
+}
+
+unsigned VarintDecoder::decode(const char* src, unsigned size, SamplePack& out, unsigned start)
+{
+    Q_ASSERT(out.numChannels() == numChannels);
+
+    auto p = (const unsigned char*) src;
+    auto end = p + size;
+
+    bool absolute = !delta;
+    if (delta)
+    {
+        absolute = *p++ == KEYFRAME_FLAG;
+    }
+
+    for (unsigned ch = 0; ch < numChannels; ch++)
+    {
+        dst[ch] = out.data(ch) + start;
+    }
+
+    unsigned ch = 0;
+    unsigned i = 0;
+    while (p < end)
+    {
+        quint64 raw = *p++;
+        if (raw & 0x80) // rest of a multi byte varint, length is checked by `accept`
+        {
+            raw &= 0x7F;
+            unsigned shift = 7;
+            quint64 b;
+            do
+            {
+                b = *p++;
+                raw |= (b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+        }
+
+        qint64 value = zigzag(raw);
+        if (!absolute)
+        {
+            // wraps around like the 64 bits accumulator of the device
+            value = (qint64) ((quint64) last[ch] + (quint64) value);
+        }
+        last[ch] = value;
+        dst[ch][i] = value;
+
+        if (++ch == numChannels)
+        {
+            ch = 0;
+            i++;
+            absolute = !delta;
+        }
+    }
+
+    Q_ASSERT(start + i <= out.numSamples());
+    return i;
+}
@@ -0,0 +1,106 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VARINTDECODER_H
+#define VARINTDECODER_H
+
+#include <QtGlobal>
+#include <vector>
+
+#include "samplepack.h"
+
+/**
+ * Decodes packets of zigzag encoded LEB128 varints into samples.
+ *
+ * Each value is a signed integer that is zigzag encoded and written
+ * with 7 bits per byte, least significant group first; high bit of a
+ * byte is set if more bytes follow. Values are interleaved, a packet
+ * contains one or more sets of channel samples.
+ *
+ * In delta mode, values are differences from the previous sample of
+ * the same channel and the first byte of a packet is a flag:
+ *
+ * - `0x00`: delta packet, first sample set is relative to the last
+ *   set of the previous packet
+ * - `0x01`: keyframe, first sample set has absolute values
+ *
+ * Running state of the channels is only valid after a keyframe, so
+ * delta packets are skipped until the next keyframe after a reset or
+ * a malformed packet.
+ */
+class VarintDecoder
+{
+public:
+    /// Longest encoding of a 64 bits value
+    static const unsigned MAX_VARINT_SIZE = 10;
+    /// Flag byte of a delta packet
+    static const quint8 DELTA_FLAG = 0x00;
+    /// Flag byte of a keyframe packet
+    static const quint8 KEYFRAME_FLAG = 0x01;
+
+    /**
+     * @param nc number of channels
+     * @param delta values are deltas, packets start with a flag byte
+     */
+    explicit VarintDecoder(unsigned nc = 1, bool delta = false);
+
+    /**
+     * Waits for a keyframe in delta mode. Running state is kept for
+     * the packets that are already accepted but not decoded yet.
+     */
+    void reset();
+
+    /// Running state is valid, always `true` if not in delta mode
+    bool synced() const;
+
+    /**
+     * Checks a packet and updates the synchronization state, should
+     * be called for each packet in order before it's decoded.
+     *
+     * @return number of samples per channel in the packet, `0` if
+     * packet should be skipped because there was no keyframe yet or
+     * `-1` if packet is malformed
+     */
+    int accept(const char* src, unsigned size);
+
+    /**
+     * Decodes an accepted packet into `out` starting from sample
+     * index `start`, running state of channels is updated.
+     *
+     * @return number of samples per channel that are decoded
+     * @note Only call for packets that are accepted with a non zero
+     * sample count, in the same order.
+     */
+    unsigned decode(const char* src, unsigned size, SamplePack& out, unsigned start);
+
+    /// Decodes a zigzag encoded value
+    static inline qint64 zigzag(quint64 value)
+    {
+        return (qint64) (value >> 1) ^ -(qint64) (value & 1);
+    }
+
+private:
+    unsigned numChannels;
+    bool delta;
+    bool _synced;
+    std::vector<qint64> last;    ///< last value of each channel
+    std::vector<double*> dst;    ///< channel pointers of current output pack
+};
+
+#endif // VARINTDECODER_H
@@ -0,0 +1,115 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QtGlobal>
+#include <algorithm>
+
+#include "xringbuffer.h"
+
+XRingBuffer::XRingBuffer(unsigned n) :
+    buffer(n)
+{
+    numValid = 0;
+}
+
+unsigned XRingBuffer::size() const
+{
+    return buffer.size();
+}
+
+double XRingBuffer::sample(unsigned i) const
+{
+    return buffer.sample(i);
+}
+
+unsigned XRingBuffer::firstValid() const
+{
+    return buffer.size() - numValid;
+}
+
+Range XRingBuffer::limits() const
+{
+    return limits(0, buffer.size());
+}
+
+Range XRingBuffer::limits(unsigned start, unsigned n) const
+{
+    Q_ASSERT(n > 0 && start + n <= buffer.size());
+
+    // skip the initial samples if range contains added ones
+    unsigned end = start + n;
+    if (numValid && start < firstValid() && end > firstValid())
+    {
+        start = firstValid();
+    }
+    return {buffer.sample(start), buffer.sample(end - 1)};
+}
+
+void XRingBuffer::copyRange(unsigned start, unsigned n, double* out) const
+{
+    buffer.copyRange(start, n, out);
+}
+
+void XRingBuffer::resize(unsigned n)
+{
+    buffer.resize(n);
+    numValid = std::min(numValid, n);
+}
+
+int XRingBuffer::findIndex(double value) const
+{
+    const unsigned start = firstValid();
+    if (numValid == 0 || value < sample(start) || value > sample(size() - 1))
+    {
+        return OUT_OF_RANGE;
+    }
+
+    // added data is sorted in both spans and continues from `first` to `second`
+    Span first, second;
+    buffer.spans(first, second);
+
+    if (start >= first.size) // only `second` contains added data
+    {
+        auto it = std::upper_bound(second.data + (start - first.size),
+                                   second.data + second.size, value);
+        return first.size + (it - second.data) - 1;
+    }
+    else if (second.size && value >= second.data[0])
+    {
+        auto it = std::upper_bound(second.data, second.data + second.size, value);
+        return first.size + (it - second.data) - 1;
+    }
+    else
+    {
+        auto it = std::upper_bound(first.data + start, first.data + first.size, value);
+        return (it - first.data) - 1;
+    }
+}
+
+void XRingBuffer::addSamples(double* samples, unsigned n)
+{
+    buffer.addSamples(samples, n);
+    numValid = std::min(numValid + n, buffer.size());
+}
+
+void XRingBuffer::clear()
+{
+    buffer.clear();
+    numValid = 0;
+}
@@ -0,0 +1,63 @@
+/*
+  Copyright © 2020 Hasan Yavuz Özderya
+
+  This file is part of serialplot.
+
+  serialplot is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  serialplot is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with serialplot.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef XRINGBUFFER_H
+#define XRINGBUFFER_H
+
+#include "framebuffer.h"
+#include "ringbuffer.h"
+
+/**
+ * A ring buffer for storing X data that is provided by the source.
+ *
+ * Added values must be increasing or equal to the previous ones, this
+ * allows limits to be known without scanning and `findIndex` to do a
+ * binary search.
+ *
+ * Buffer starts filled with 0, these samples aren't sorted with
+ * respect to the added ones (e.g. negative X), so they are excluded
+ * from limits and search until they are overwritten.
+ */
+class XRingBuffer : public XFrameBuffer
+{
+public:
+    XRingBuffer(unsigned n);
+
+    unsigned size() const override;
+    double sample(unsigned i) const override;
+    Range limits() const override;
+    Range limits(unsigned start, unsigned n) const override;
+    void copyRange(unsigned start, unsigned n, double* out) const override;
+    void resize(unsigned n) override;
+    int findIndex(double value) const override;
+
+    /// Add samples to the buffer, must be in increasing order
+    void addSamples(double* samples, unsigned n);
+    /// Reset all data to 0
+    void clear();
+
+private:
+    RingBuffer buffer;
+    unsigned numValid;          ///< number of added samples at the end of buffer
+
+    /// Index of the first added sample
+    unsigned firstValid() const;
+};
+
+#endif // XRINGBUFFER_H
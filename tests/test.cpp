@@ -20,12 +20,27 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include "catch.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <vector>
+
 #include "samplepack.h"
+#include "samplepackpool.h"
 #include "source.h"
+#include "capturetime.h"
 #include "indexbuffer.h"
 #include "linindexbuffer.h"
 #include "ringbuffer.h"
 #include "readonlybuffer.h"
+#include "xringbuffer.h"
+#include "compressedhistory.h"
+#include "multiringbuffer.h"
+#include "sampledecoder.h"
+#include "framelayout.h"
+#include "messagetable.h"
+#include "deviceclock.h"
+#include "varintdecoder.h"
 
 #include "test_helpers.h"
 
@@ -79,6 +94,96 @@ TEST_CASE("samplepack copy", "[memory]")
     }
 }
 
+TEST_CASE("samplepack move", "[memory]")
+{
+    SamplePack pack(10, 2, true);
+    double* data = pack.data(0);
+    data[3] = 42;
+
+    SamplePack other(std::move(pack));
+    REQUIRE(other.data(0) == data);
+    REQUIRE(other.data(0)[3] == 42);
+    REQUIRE(other.hasX());
+    REQUIRE(pack.numChannels() == 0);
+    REQUIRE(pack.numSamples() == 0);
+
+    SamplePack third(1, 1);
+    third = std::move(other);
+    REQUIRE(third.data(0) == data);
+    REQUIRE(third.numSamples() == 10);
+    REQUIRE(third.numChannels() == 2);
+}
+
+TEST_CASE("samplepack reshape", "[memory]")
+{
+    SamplePack pack(10, 3, false);
+    double* data = pack.data(0);
+
+    // smaller shape should re-use storage
+    pack.reshape(5, 4, false);
+    REQUIRE(pack.numSamples() == 5);
+    REQUIRE(pack.numChannels() == 4);
+    REQUIRE(!pack.hasX());
+    REQUIRE(pack.data(0) == data);
+    REQUIRE(pack.data(3) == data + 15);
+
+    pack.reshape(30, 1, true);
+    REQUIRE(pack.hasX());
+    REQUIRE(pack.data(0) == data);
+    pack.xData()[29] = 1;
+
+    pack.reshape(20, 2, false);
+    REQUIRE(pack.numSamples() == 20);
+    REQUIRE(!pack.hasX());
+    pack.data(1)[19] = 1;
+}
+
+TEST_CASE("samplepack timestamp", "[memory]")
+{
+    SamplePack pack(4, 2);
+    REQUIRE_FALSE(pack.hasTimestamp());
+
+    pack.setTimestamp(1000, 10);
+    REQUIRE(pack.hasTimestamp());
+    REQUIRE(pack.timestamp() == 1000);
+    REQUIRE(pack.sampleTime(3) == 1000);
+    REQUIRE(pack.sampleTime(0) == 970);
+
+    // copied and moved with the pack
+    SamplePack copy(pack);
+    REQUIRE(copy.timestamp() == 1000);
+    REQUIRE(copy.sampleInterval() == 10);
+    SamplePack moved(std::move(copy));
+    REQUIRE(moved.timestamp() == 1000);
+
+    // cleared when pack is re-used
+    moved.reshape(2, 2);
+    REQUIRE_FALSE(moved.hasTimestamp());
+    REQUIRE(moved.sampleInterval() == 0);
+}
+
+
+TEST_CASE("samplepack pool", "[memory]")
+{
+    SamplePackPool pool;
+
+    SamplePack pack = pool.take(10, 2);
+    REQUIRE(pack.numSamples() == 10);
+    REQUIRE(pack.numChannels() == 2);
+    double* data = pack.data(0);
+
+    pool.recycle(std::move(pack));
+    SamplePack other = pool.take(5, 3, true);
+    REQUIRE(other.data(0) == data);
+    REQUIRE(other.numSamples() == 5);
+    REQUIRE(other.numChannels() == 3);
+    REQUIRE(other.hasX());
+
+    // pool is empty, a new pack should be created
+    SamplePack third = pool.take(5, 3);
+    REQUIRE(third.data(0) != data);
+}
+
 TEST_CASE("sink", "[memory, stream]")
 {
     TestSink sink;
@@ -169,6 +274,13 @@ TEST_CASE("source disconnect all sinks", "[memory, stream]")
     }
 }
 
+TEST_CASE("capture time", "[memory, stream]")
+{
+    qint64 t = captureTime();
+    REQUIRE(captureTime() >= t);
+    REQUIRE(captureTimeToEpoch(t) > t);
+}
+
 TEST_CASE("IndexBuffer", "[memory, buffer]")
 {
     IndexBuffer buf(10);
@@ -280,6 +392,43 @@ TEST_CASE("RingBuffer data access", "[memory, buffer]")
     }
 }
 
+TEST_CASE("RingBuffer bulk access", "[memory, buffer]")
+{
+    RingBuffer buf(10);
+    double values[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    buf.addSamples(values, 10);
+    buf.addSamples(values, 3); // wrap around
+
+    Span first, second;
+    buf.spans(first, second);
+    REQUIRE(first.size + second.size == 10);
+    for (unsigned i = 0; i < 10; i++)
+    {
+        double v = i < first.size ? first.data[i] : second.data[i - first.size];
+        REQUIRE(v == buf.sample(i));
+    }
+
+    double out[10];
+    buf.copyRange(0, 10, out);
+    for (unsigned i = 0; i < 10; i++)
+    {
+        REQUIRE(out[i] == buf.sample(i));
+    }
+
+    buf.copyRange(5, 4, out); // crosses the end of storage
+    for (unsigned i = 0; i < 4; i++)
+    {
+        REQUIRE(out[i] == buf.sample(i + 5));
+    }
+
+    ReadOnlyBuffer copy(&buf, 2, 7);
+    for (unsigned i = 0; i < 7; i++)
+    {
+        REQUIRE(copy.sample(i) == buf.sample(i + 2));
+    }
+}
+
 TEST_CASE("making RingBuffer bigger should keep end values", "[memory, buffer]")
 {
     RingBuffer buf(5);
@@ -340,6 +489,102 @@ TEST_CASE("RingBuffer limits", "[memory, buffer]")
     REQUIRE(lim.end == 9.);
 }
 
+TEST_CASE("RingBuffer limits should skip NaN", "[memory, buffer]")
+{
+    RingBuffer buf(4);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double values[4] = {nan, 2, nan, -1};
+
+    buf.addSamples(values, 4);
+    auto lim = buf.limits();
+    REQUIRE(lim.start == -1.);
+    REQUIRE(lim.end == 2.);
+
+    lim = buf.limits(0, 3);
+    REQUIRE(lim.start == 2.);
+    REQUIRE(lim.end == 2.);
+}
+
+TEST_CASE("RingBuffer limits should match a full scan", "[memory, buffer]")
+{
+    const unsigned size = 1000; // spans multiple limit blocks
+    RingBuffer buf(size);
+    double values[size];
+
+    auto scanLimits = [&buf]()
+        {
+            Range lim = {buf.sample(0), buf.sample(0)};
+            for (unsigned i = 0; i < buf.size(); i++)
+            {
+                lim.start = std::min(lim.start, buf.sample(i));
+                lim.end = std::max(lim.end, buf.sample(i));
+            }
+            return lim;
+        };
+
+    // add chunks of various sizes so that head wraps around at different places
+    unsigned counter = 0;
+    for (unsigned n : {1u, 7u, 128u, 300u, 999u, 1000u, 1500u, 3u, 250u})
+    {
+        double* samples = new double[n];
+        for (unsigned i = 0; i < n; i++)
+        {
+            // a sawtooth with a moving peak
+            samples[i] = (counter % 97) - (counter % 13) * 0.5;
+            counter++;
+        }
+        buf.addSamples(samples, n);
+        delete[] samples;
+
+        auto lim = buf.limits();
+        auto expected = scanLimits();
+        REQUIRE(lim.start == expected.start);
+        REQUIRE(lim.end == expected.end);
+    }
+
+    // limits should be kept after resize
+    for (unsigned i = 0; i < size; i++) values[i] = i;
+    buf.addSamples(values, size);
+    buf.resize(size/2);
+    auto lim = buf.limits();
+    REQUIRE(lim.start == size/2);
+    REQUIRE(lim.end == size-1);
+}
+
+TEST_CASE("RingBuffer range limits", "[memory, buffer]")
+{
+    const unsigned size = 1000;
+    RingBuffer buf(size);
+
+    // fill so that head is in the middle of the array
+    double values[size + 300];
+    for (unsigned i = 0; i < size + 300; i++)
+    {
+        values[i] = (i * 37) % 101;
+    }
+    buf.addSamples(values, size + 300);
+    buf.addSamples(values, 300);
+
+    for (unsigned start : {0u, 1u, 100u, 127u, 128u, 650u, 700u, 999u})
+    {
+        for (unsigned n : {1u, 2u, 50u, 129u, 300u, 500u, 1000u})
+        {
+            if (start + n > size) continue;
+
+            Range expected = {buf.sample(start), buf.sample(start)};
+            for (unsigned i = start; i < start + n; i++)
+            {
+                expected.start = std::min(expected.start, buf.sample(i));
+                expected.end = std::max(expected.end, buf.sample(i));
+            }
+
+            auto lim = buf.limits(start, n);
+            REQUIRE(lim.start == expected.start);
+            REQUIRE(lim.end == expected.end);
+        }
+    }
+}
+
 TEST_CASE("RingBuffer clear", "[memory, buffer]")
 {
     RingBuffer buf(10);
@@ -358,6 +603,281 @@ TEST_CASE("RingBuffer clear", "[memory, buffer]")
     REQUIRE(lim.end == 0.);
 }
 
+TEST_CASE("RingBuffer with integer storage", "[memory, buffer]")
+{
+    RingBufferOf<qint16> buf(10);
+    double values[12] = {1, -2, 3, 40000, -40000, 6.7, 7, 8, 9, 10, 11, 12};
+
+    buf.addSamples(values, 12);
+
+    REQUIRE(buf.size() == 10);
+    REQUIRE(buf.sample(0) == 3);
+    REQUIRE(buf.sample(1) == 32767);  // clamped
+    REQUIRE(buf.sample(2) == -32768); // clamped
+    REQUIRE(buf.sample(3) == 6);      // fraction is dropped
+    REQUIRE(buf.sample(9) == 12);
+
+    auto lim = buf.limits();
+    REQUIRE(lim.start == -32768);
+    REQUIRE(lim.end == 32767);
+
+    lim = buf.limits(3, 7);
+    REQUIRE(lim.start == 6);
+    REQUIRE(lim.end == 12);
+
+    double out[10];
+    buf.copyRange(0, 10, out);
+    for (unsigned i = 0; i < 10; i++)
+    {
+        REQUIRE(out[i] == buf.sample(i));
+    }
+
+    buf.resize(12);
+    REQUIRE(buf.sample(0) == 0);
+    REQUIRE(buf.sample(2) == 3);
+    REQUIRE(buf.sample(11) == 12);
+}
+
+TEST_CASE("RingBuffer with float storage", "[memory, buffer]")
+{
+    RingBufferOf<float> buf(4);
+    double values[4] = {0.5, -1.25, 1e10, 3};
+
+    buf.addSamples(values, 4);
+
+    REQUIRE(buf.sample(0) == 0.5);
+    REQUIRE(buf.sample(1) == -1.25);
+    REQUIRE(buf.sample(2) == float(1e10));
+    auto lim = buf.limits();
+    REQUIRE(lim.start == -1.25);
+    REQUIRE(lim.end == float(1e10));
+
+    SpanOf<float> first, second;
+    buf.spans(first, second);
+    REQUIRE(first.size + second.size == 4);
+    REQUIRE(first.data[3] == 3.f);
+
+    buf.clear();
+    REQUIRE(buf.sample(3) == 0);
+}
+
+TEST_CASE("MultiRingBuffer", "[memory, buffer]")
+{
+    MultiRingBufferOf<double> buf(3, 10);
+    REQUIRE(buf.numChannels() == 3);
+    REQUIRE(buf.size() == 10);
+    for (unsigned ci = 0; ci < 3; ci++)
+    {
+        REQUIRE(buf.channel(ci)->size() == 10);
+        REQUIRE(buf.channel(ci)->sample(5) == 0);
+    }
+
+    // add data twice so that it wraps around
+    SamplePack pack(7, 3);
+    for (unsigned ci = 0; ci < 3; ci++)
+    {
+        for (unsigned i = 0; i < 7; i++)
+        {
+            pack.data(ci)[i] = ci * 100 + i;
+        }
+    }
+    buf.addSamples(pack);
+    buf.addSamples(pack);
+
+    for (unsigned ci = 0; ci < 3; ci++)
+    {
+        auto y = buf.channel(ci);
+        REQUIRE(y->sample(0) == ci * 100 + 4);
+        REQUIRE(y->sample(2) == ci * 100 + 6);
+        REQUIRE(y->sample(3) == ci * 100 + 0);
+        REQUIRE(y->sample(9) == ci * 100 + 6);
+
+        auto lim = y->limits();
+        REQUIRE(lim.start == ci * 100);
+        REQUIRE(lim.end == ci * 100 + 6);
+        lim = y->limits(1, 3);
+        REQUIRE(lim.start == ci * 100);
+        REQUIRE(lim.end == ci * 100 + 6);
+
+        double out[10];
+        y->copyRange(0, 10, out);
+        for (unsigned i = 0; i < 10; i++)
+        {
+            REQUIRE(out[i] == y->sample(i));
+        }
+    }
+}
+
+TEST_CASE("MultiRingBuffer resizing", "[memory, buffer]")
+{
+    MultiRingBufferOf<qint16> buf(2, 5);
+    SamplePack pack(7, 2);
+    for (unsigned i = 0; i < 7; i++)
+    {
+        pack.data(0)[i] = i;
+        pack.data(1)[i] = -(double) i;
+    }
+    buf.addSamples(pack); // 2, 3, 4, 5, 6
+
+    // channel buffers should stay valid
+    const FrameBuffer* y0 = buf.channel(0);
+    const FrameBuffer* y1 = buf.channel(1);
+
+    buf.resize(8);
+    REQUIRE(y0->size() == 8);
+    REQUIRE(y0->sample(0) == 0);
+    REQUIRE(y0->sample(3) == 2);
+    REQUIRE(y0->sample(7) == 6);
+    REQUIRE(y1->sample(7) == -6);
+    REQUIRE(y1->limits().start == -6);
+
+    buf.resize(3);
+    REQUIRE(y0->sample(0) == 4);
+    REQUIRE(y0->sample(2) == 6);
+    REQUIRE(y0->limits().start == 4);
+
+    buf.setNumChannels(3);
+    REQUIRE(buf.numChannels() == 3);
+    REQUIRE(buf.channel(0) == y0);
+    REQUIRE(y1->sample(2) == -6);
+    REQUIRE(buf.channel(2)->sample(2) == 0);
+
+    buf.setNumChannels(1);
+    REQUIRE(y0->sample(2) == 6);
+    REQUIRE(y0->limits().end == 6);
+
+    buf.clear();
+    REQUIRE(y0->sample(2) == 0);
+    REQUIRE(y0->limits().end == 0);
+}
+
+TEST_CASE("MultiRingBuffer snapshot", "[memory, buffer]")
+{
+    typedef MultiRingBufferOf<qint32> Buffer;
+    const unsigned N = Buffer::PAGE_SIZE * 2 + 100;
+
+    Buffer* buf = new Buffer(2, N);
+    SamplePack pack(N + 50, 2);
+    for (unsigned i = 0; i < N + 50; i++)
+    {
+        pack.data(0)[i] = i;
+        pack.data(1)[i] = -(double) i;
+    }
+    buf->addSamples(pack); // head is not at 0
+
+    FrameBuffer* snap = buf->snapshot(0);
+    FrameBuffer* snap2 = buf->snapshot(1);
+    REQUIRE(snap->size() == N);
+    REQUIRE(snap->sample(0) == 50);
+    REQUIRE(snap->sample(N-1) == N + 49);
+    REQUIRE(snap->limits().start == 50);
+    REQUIRE(snap->limits().end == N + 49);
+    REQUIRE(snap2->limits().start == -(double) (N + 49));
+
+    // overwrite part of the buffer, snapshot shouldn't change
+    SamplePack pack2(Buffer::PAGE_SIZE + 10, 2);
+    for (unsigned i = 0; i < pack2.numSamples(); i++)
+    {
+        pack2.data(0)[i] = 1000000;
+        pack2.data(1)[i] = 1000000;
+    }
+    buf->addSamples(pack2);
+    REQUIRE(buf->channel(0)->limits().end == 1000000);
+
+    for (unsigned i = 0; i < N; i++)
+    {
+        REQUIRE(snap->sample(i) == i + 50);
+    }
+    REQUIRE(snap->limits().end == N + 49);
+    REQUIRE(snap->limits(10, 5000).start == 60);
+    REQUIRE(snap->limits(10, 5000).end == 5059);
+    REQUIRE(snap->limits(N - 60, 60).start == N - 10);
+
+    std::vector<double> out(N);
+    snap->copyRange(0, N, out.data());
+    REQUIRE(out[0] == 50);
+    REQUIRE(out[N-1] == N + 49);
+
+    // snapshot can be deleted before the buffer
+    delete snap2;
+
+    // or can outlive it
+    delete buf;
+    REQUIRE(snap->sample(0) == 50);
+    REQUIRE(snap->sample(N-1) == N + 49);
+    REQUIRE(snap->limits().end == N + 49);
+    delete snap;
+}
+
+TEST_CASE("CompressedHistory", "[memory, history]")
+{
+    const unsigned B = CompressedHistory::BLOCK_SIZE;
+    const unsigned N = B * 3 + 100;
+
+    CompressedHistory h(2);
+    REQUIRE(h.numChannels() == 2);
+    REQUIRE(h.size() == 0);
+
+    // channel 0 is integer (delta coded), channel 1 is not (XOR coded)
+    std::vector<double> ints(N), reals(N);
+    for (unsigned i = 0; i < N; i++)
+    {
+        ints[i] = 1000 + (int) (i % 50) - 25;
+        reals[i] = sin(i / 100.) * 3.3;
+    }
+    reals[B + 5] = -1e300;
+    reals[B + 6] = 0;
+
+    // append in 2 steps, uncommitted samples are not visible
+    h.append(0, 0, ints.data(), B + 10);
+    h.append(1, 0, reals.data(), B + 10);
+    REQUIRE(h.size() == 0);
+    h.commit(B + 10);
+    REQUIRE(h.size() == B + 10);
+
+    RingBuffer buf(N);
+    SamplePack pack(N, 1);
+    std::copy(reals.begin(), reals.end(), pack.data(0));
+    buf.addSamples(pack.data(0), N);
+    h.append(0, 0, ints.data() + B + 10, N - B - 10);
+    h.append(1, 0, &buf, B + 10, N - B - 10);
+    h.commit(N - B - 10);
+    REQUIRE(h.size() == N);
+
+    for (unsigned i = 0; i < N; i++)
+    {
+        REQUIRE(h.sample(0, i) == ints[i]);
+        REQUIRE(h.sample(1, i) == reals[i]);
+    }
+
+    std::vector<double> out(N);
+    h.copyRange(1, 0, N, out.data());
+    REQUIRE(out == reals);
+    h.copyRange(0, 10, N - 20, out.data());
+    REQUIRE(std::equal(out.begin(), out.begin() + N - 20, ints.begin() + 10));
+
+    auto lim = h.limits(0, 0, N);
+    REQUIRE(lim.start == 975);
+    REQUIRE(lim.end == 1024);
+    lim = h.limits(1, 0, N);
+    REQUIRE(lim.start == -1e300);
+    lim = h.limits(0, 3, 10);
+    REQUIRE(lim.start == 978);
+    REQUIRE(lim.end == 987);
+
+    REQUIRE(h.compressedSize() < 2 * 3 * B * sizeof(double));
+
+    // integer channel should compress well
+    CompressedHistory hi(1);
+    hi.append(0, 0, ints.data(), N);
+    hi.commit(N);
+    REQUIRE(hi.compressedSize() < 3 * B * sizeof(double) / 4);
+
+    h.clear();
+    REQUIRE(h.size() == 0);
+    REQUIRE(h.compressedSize() == 0);
+}
+
 TEST_CASE("ReadOnlyBuffer", "[memory, buffer]")
 {
     IndexBuffer source(10);
@@ -389,3 +909,597 @@ TEST_CASE("ReadOnlyBuffer sliced constructor", "[memory, buffer]")
         REQUIRE(buf.sample(i) == (i + 5));
     }
 }
+
+TEST_CASE("ReadOnlyBuffer range limits", "[memory, buffer]")
+{
+    double values[10] = {5, 2, 3, 9, 5, 6, 1, 8, 9, 4};
+    ReadOnlyBuffer buf(values, 10);
+
+    auto lim = buf.limits(0, 10);
+    REQUIRE(lim.start == 1.);
+    REQUIRE(lim.end == 9.);
+
+    lim = buf.limits(1, 3);
+    REQUIRE(lim.start == 2.);
+    REQUIRE(lim.end == 9.);
+
+    lim = buf.limits(7, 1);
+    REQUIRE(lim.start == 8.);
+    REQUIRE(lim.end == 8.);
+
+    IndexBuffer ibuf(10);
+    lim = ibuf.limits(2, 5);
+    REQUIRE(lim.start == 2.);
+    REQUIRE(lim.end == 6.);
+}
+
+TEST_CASE("XRingBuffer", "[memory, buffer]")
+{
+    XRingBuffer buf(10);
+    double values[15];
+    for (unsigned i = 0; i < 15; i++)
+    {
+        values[i] = 10 + i * 2;
+    }
+
+    buf.addSamples(values, 10);
+    buf.addSamples(&values[10], 5); // wraps around, X is now 20 to 38
+
+    REQUIRE(buf.size() == 10);
+    REQUIRE(buf.sample(0) == 20.);
+    REQUIRE(buf.sample(9) == 38.);
+
+    auto lim = buf.limits();
+    REQUIRE(lim.start == 20.);
+    REQUIRE(lim.end == 38.);
+    lim = buf.limits(2, 3);
+    REQUIRE(lim.start == 24.);
+    REQUIRE(lim.end == 28.);
+
+    REQUIRE(buf.findIndex(19.9) == XFrameBuffer::OUT_OF_RANGE);
+    REQUIRE(buf.findIndex(38.1) == XFrameBuffer::OUT_OF_RANGE);
+    REQUIRE(buf.findIndex(20.) == 0);
+    REQUIRE(buf.findIndex(21.) == 0);
+    REQUIRE(buf.findIndex(29.) == 4);  // at the end of storage
+    REQUIRE(buf.findIndex(30.) == 5);  // at the beginning of storage
+    REQUIRE(buf.findIndex(37.) == 8);
+    REQUIRE(buf.findIndex(38.) == 9);
+    for (unsigned i = 0; i < 10; i++)
+    {
+        REQUIRE(buf.findIndex(buf.sample(i)) == (int) i);
+    }
+}
+
+TEST_CASE("XRingBuffer with negative values", "[memory, buffer]")
+{
+    XRingBuffer buf(10);
+    REQUIRE(buf.findIndex(0.) == XFrameBuffer::OUT_OF_RANGE);
+
+    // initial zeros shouldn't break the order
+    double values[] = {-5, -4, -3, -2};
+    buf.addSamples(values, 4);
+    REQUIRE(buf.findIndex(0.) == XFrameBuffer::OUT_OF_RANGE);
+    REQUIRE(buf.findIndex(-5.) == 6);
+    REQUIRE(buf.findIndex(-2.5) == 8);
+    REQUIRE(buf.findIndex(-2.) == 9);
+    auto lim = buf.limits();
+    REQUIRE(lim.start == -5.);
+    REQUIRE(lim.end == -2.);
+    lim = buf.limits(4, 4);
+    REQUIRE(lim.start == -5.);
+    REQUIRE(lim.end == -4.);
+
+    // grow and wrap around
+    buf.resize(12);
+    double more[] = {-1, 0};
+    buf.addSamples(more, 2);
+    REQUIRE(buf.findIndex(-6.) == XFrameBuffer::OUT_OF_RANGE);
+    REQUIRE(buf.findIndex(-5.) == 6);
+    REQUIRE(buf.findIndex(-1.) == 10);
+    REQUIRE(buf.findIndex(0.) == 11);
+    lim = buf.limits();
+    REQUIRE(lim.start == -5.);
+    REQUIRE(lim.end == 0.);
+
+    buf.clear();
+    REQUIRE(buf.findIndex(0.) == XFrameBuffer::OUT_OF_RANGE);
+}
+
+TEST_CASE("sample decoder", "[reader]")
+{
+    REQUIRE(sampleSize(NumberFormat_int8) == 1);
+    REQUIRE(sampleSize(NumberFormat_uint16) == 2);
+    REQUIRE(sampleSize(NumberFormat_int24) == 3);
+    REQUIRE(sampleSize(NumberFormat_float) == 4);
+    REQUIRE(sampleSize(NumberFormat_double) == 8);
+
+    // 3 packages of 2 channels
+    const char data16[] = {0x01, 0x02, 0x03, 0x04,
+                           0x05, 0x06, 0x07, 0x08,
+                           (char) 0xFF, (char) 0xFE, 0x00, 0x01};
+    SamplePack pack(4, 2);
+
+    SampleDecoder decoder(NumberFormat_uint16, LittleEndian, 2);
+    REQUIRE(decoder.sampleSize() == 2);
+    decoder.decode(data16, 3, pack, 1);
+    REQUIRE(pack.data(0)[1] == 0x0201);
+    REQUIRE(pack.data(1)[1] == 0x0403);
+    REQUIRE(pack.data(0)[3] == 0xFEFF);
+    REQUIRE(pack.data(1)[3] == 0x0100);
+
+    decoder = SampleDecoder(NumberFormat_int16, BigEndian, 2);
+    decoder.decode(data16, 3, pack, 0);
+    REQUIRE(pack.data(0)[0] == 0x0102);
+    REQUIRE(pack.data(1)[1] == 0x0708);
+    REQUIRE(pack.data(0)[2] == -2);
+
+    // channel count that isn't specialized
+    SamplePack pack6(2, 6);
+    decoder = SampleDecoder(NumberFormat_int8, LittleEndian, 6);
+    decoder.decode(data16, 2, pack6, 0);
+    REQUIRE(pack6.data(0)[0] == 1);
+    REQUIRE(pack6.data(5)[0] == 6);
+    REQUIRE(pack6.data(0)[1] == 7);
+    REQUIRE(pack6.data(2)[1] == -1);
+    REQUIRE(pack6.data(5)[1] == 1);
+
+    // float, big endian
+    const char dataf[] = {0x3F, (char) 0xC0, 0x00, 0x00,
+                          (char) 0xC1, 0x20, 0x00, 0x00};
+    SamplePack packf(2, 1);
+    decoder = SampleDecoder(NumberFormat_float, BigEndian, 1);
+    decoder.decode(dataf, 2, packf, 0);
+    REQUIRE(packf.data(0)[0] == 1.5);
+    REQUIRE(packf.data(0)[1] == -10);
+
+    // double and int64
+    const char data64[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, (char) 0xF8, 0x3F,
+                           (char) 0xFE, (char) 0xFF, (char) 0xFF, (char) 0xFF,
+                           (char) 0xFF, (char) 0xFF, (char) 0xFF, (char) 0xFF};
+    decoder = SampleDecoder(NumberFormat_double, LittleEndian, 1);
+    decoder.decode(data64, 1, packf, 0);
+    REQUIRE(packf.data(0)[0] == 1.5);
+    decoder = SampleDecoder(NumberFormat_int64, LittleEndian, 1);
+    decoder.decode(data64 + 8, 1, packf, 0);
+    REQUIRE(packf.data(0)[0] == -2);
+}
+
+TEST_CASE("sample decoder packed and fixed point formats", "[reader]")
+{
+    SamplePack pack(2, 2);
+
+    // 24 bits integers
+    const char data24[] = {0x01, 0x02, 0x03, (char) 0xFF, (char) 0xFF, (char) 0xFE,
+                           (char) 0x80, 0x00, 0x00, 0x7F, (char) 0xFF, (char) 0xFF};
+    SampleDecoder decoder(NumberFormat_int24, BigEndian, 2);
+    decoder.decode(data24, 2, pack, 0);
+    REQUIRE(pack.data(0)[0] == 0x010203);
+    REQUIRE(pack.data(1)[0] == -2);
+    REQUIRE(pack.data(0)[1] == -8388608);
+    REQUIRE(pack.data(1)[1] == 8388607);
+
+    decoder = SampleDecoder(NumberFormat_uint24, LittleEndian, 2);
+    decoder.decode(data24, 2, pack, 0);
+    REQUIRE(pack.data(0)[0] == 0x030201);
+    REQUIRE(pack.data(1)[0] == 0xFEFFFF);
+
+    // half precision: 1, -2, 65504 (max), smallest subnormal
+    const char dataHalf[] = {0x00, 0x3C, 0x00, (char) 0xC0,
+                             (char) 0xFF, 0x7B, 0x01, 0x00};
+    decoder = SampleDecoder(NumberFormat_half, LittleEndian, 2);
+    decoder.decode(dataHalf, 2, pack, 0);
+    REQUIRE(pack.data(0)[0] == 1);
+    REQUIRE(pack.data(1)[0] == -2);
+    REQUIRE(pack.data(0)[1] == 65504);
+    REQUIRE(pack.data(1)[1] == ldexp(1., -24));
+
+    SamplePack pack1(2, 1);
+
+    // bfloat16: 1.5, -10
+    const char dataBf[] = {0x3F, (char) 0xC0, (char) 0xC1, 0x20};
+    decoder = SampleDecoder(NumberFormat_bfloat16, BigEndian, 1);
+    decoder.decode(dataBf, 2, pack1, 0);
+    REQUIRE(pack1.data(0)[0] == 1.5);
+    REQUIRE(pack1.data(0)[1] == -10);
+
+    // Q15: 0.5, -1
+    const char dataQ15[] = {0x40, 0x00, (char) 0x80, 0x00};
+    decoder = SampleDecoder(NumberFormat_q16, BigEndian, 1, 15);
+    decoder.decode(dataQ15, 2, pack1, 0);
+    REQUIRE(pack1.data(0)[0] == 0.5);
+    REQUIRE(pack1.data(0)[1] == -1);
+
+    // Q16.16: 1.25
+    const char dataQ32[] = {0x00, 0x40, 0x01, 0x00};
+    decoder = SampleDecoder(NumberFormat_q32, LittleEndian, 1, 16);
+    decoder.decode(dataQ32, 1, pack1, 0);
+    REQUIRE(pack1.data(0)[0] == 1.25);
+}
+
+/// Packs `values` back to back with `bits` width, in given bit order
+static std::vector<char> packBits(const std::vector<unsigned>& values, unsigned bits,
+                                  bool bigEndian)
+{
+    std::vector<char> packed((values.size() * bits + 7) / 8, 0);
+    unsigned pos = 0;
+    for (auto v : values)
+    {
+        for (unsigned b = 0; b < bits; b++, pos++)
+        {
+            // little endian starts from LSB, big endian from MSB
+            unsigned bit = bigEndian ? (v >> (bits - 1 - b)) & 1 : (v >> b) & 1;
+            unsigned shift = bigEndian ? 7 - pos % 8 : pos % 8;
+            packed[pos / 8] |= bit << shift;
+        }
+    }
+    return packed;
+}
+
+TEST_CASE("sample decoder bit packed formats", "[reader]")
+{
+    // 2 samples in 3 bytes
+    const char data12[] = {0x01, 0x23, 0x45};
+    SamplePack pack1(2, 1);
+    SampleDecoder decoder(NumberFormat_uint12, LittleEndian, 1);
+    REQUIRE(decoder.packageSize() == 3);
+    REQUIRE(decoder.packageSamples() == 2);
+    decoder.decode(data12, 1, pack1, 0);
+    REQUIRE(pack1.data(0)[0] == 0x301);
+    REQUIRE(pack1.data(0)[1] == 0x452);
+
+    decoder = SampleDecoder(NumberFormat_uint12, BigEndian, 1);
+    decoder.decode(data12, 1, pack1, 0);
+    REQUIRE(pack1.data(0)[0] == 0x012);
+    REQUIRE(pack1.data(0)[1] == 0x345);
+
+    // compare against a simple bit packer for various channel counts
+    const NumberFormat formats[] = {NumberFormat_uint10, NumberFormat_uint12, NumberFormat_uint14};
+    const unsigned widths[] = {10, 12, 14};
+    for (unsigned f = 0; f < 3; f++)
+    {
+        for (unsigned nc = 1; nc <= 5; nc++)
+        {
+            for (bool big : {false, true})
+            {
+                SampleDecoder dec(formats[f], big ? BigEndian : LittleEndian, nc);
+                REQUIRE((dec.packageSize() * 8) == dec.packageSamples() * nc * widths[f]);
+
+                const unsigned numPackages = 3;
+                const unsigned ns = numPackages * dec.packageSamples();
+                std::vector<unsigned> values(ns * nc);
+                for (unsigned i = 0; i < values.size(); i++)
+                {
+                    values[i] = (i * 2654435761u) & ((1u << widths[f]) - 1);
+                }
+                auto packed = packBits(values, widths[f], big);
+                REQUIRE(packed.size() == numPackages * dec.packageSize());
+
+                SamplePack pack(ns + 1, nc);
+                dec.decode(packed.data(), numPackages, pack, 1);
+                for (unsigned i = 0; i < ns; i++)
+                {
+                    for (unsigned ci = 0; ci < nc; ci++)
+                    {
+                        REQUIRE(pack.data(ci)[i + 1] == values[i * nc + ci]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("frame layout", "[reader]")
+{
+    REQUIRE(FrameLayout().isEmpty());
+    REQUIRE(FrameLayout(" ").isValid());
+    REQUIRE(FrameLayout(" ").isEmpty());
+
+    FrameLayout layout("uint32, 3*int16:be, pad, float@12");
+    REQUIRE(layout.isValid());
+    REQUIRE(layout.numChannels() == 5);
+    REQUIRE(layout.size() == 16);
+    REQUIRE(layout.fields()[1].offset == 4);
+    REQUIRE(layout.fields()[3].offset == 8);
+    REQUIRE(layout.fields()[3].endianness == BigEndian);
+    REQUIRE_FALSE(layout.fields()[3].defaultEndianness);
+    REQUIRE(layout.fields()[4].offset == 12);
+    REQUIRE(layout.fields()[4].defaultEndianness);
+
+    REQUIRE_FALSE(FrameLayout("uint8, int").isValid());
+    REQUIRE(FrameLayout("uint8, int").isEmpty());
+    REQUIRE_FALSE(FrameLayout("uint8,,uint8").isValid());
+    REQUIRE_FALSE(FrameLayout("uint8:me").isValid());
+    REQUIRE_FALSE(FrameLayout("0*uint8").isValid());
+    REQUIRE_FALSE(FrameLayout("uint8@x").isValid());
+    REQUIRE_FALSE(FrameLayout("4*pad").isValid()); // no channels
+    REQUIRE_FALSE(FrameLayout("65*uint8").isValid()); // too many channels
+    REQUIRE_FALSE(FrameLayout("uint12").isValid()); // bit packed
+
+    // bit fields
+    FrameLayout bits("uint8, 2*uint16{12|x2|s2}:be");
+    REQUIRE(bits.isValid());
+    REQUIRE(bits.numChannels() == 5);
+    REQUIRE(bits.size() == 5);
+    REQUIRE(bits.fields()[1].offset == 1);
+    REQUIRE(bits.fields()[2].offset == 1);
+    REQUIRE(bits.fields()[2].bitShift == 14);
+    REQUIRE(bits.fields()[2].bitWidth == 2);
+    REQUIRE(bits.fields()[2].bitSigned);
+    REQUIRE(bits.fields()[3].offset == 3);
+    REQUIRE(bits.fields()[3].bitWidth == 12);
+    REQUIRE_FALSE(bits.fields()[3].bitSigned);
+    REQUIRE_FALSE(FrameLayout("uint16{12|5}").isValid()); // too wide
+    REQUIRE_FALSE(FrameLayout("uint16{12|0}").isValid());
+    REQUIRE_FALSE(FrameLayout("uint16{x16}").isValid()); // no channels
+    REQUIRE_FALSE(FrameLayout("float{4}").isValid());
+    REQUIRE_FALSE(FrameLayout("uint16{4").isValid());
+}
+
+TEST_CASE("message table", "[reader]")
+{
+    REQUIRE(MessageTable().isEmpty());
+    REQUIRE(MessageTable(" ").isValid());
+
+    MessageTable table("1: uint32, 2*int16; 0x10: float;");
+    REQUIRE(table.isValid());
+    REQUIRE(table.messages().size() == 2);
+    REQUIRE(table.numChannels() == 4);
+    REQUIRE(table.indexOf(1) == 0);
+    REQUIRE(table.indexOf(16) == 1);
+    REQUIRE(table.indexOf(2) == -1);
+    REQUIRE(table.messages()[1].firstChannel == 3);
+    REQUIRE(table.messages()[1].layout.size() == 4);
+
+    // leading zeros are decimal, hexadecimal needs a prefix
+    MessageTable zeros("010: uint8; 09: uint8; 0X1f: uint8");
+    REQUIRE(zeros.isValid());
+    REQUIRE(zeros.indexOf(10) == 0);
+    REQUIRE(zeros.indexOf(9) == 1);
+    REQUIRE(zeros.indexOf(31) == 2);
+    REQUIRE_FALSE(MessageTable("1f: uint8").isValid());
+    REQUIRE_FALSE(MessageTable("0x: uint8").isValid());
+
+    REQUIRE_FALSE(MessageTable("uint8").isValid());
+    REQUIRE_FALSE(MessageTable("256: uint8").isValid());
+    REQUIRE_FALSE(MessageTable("1: uint8; 1: int8").isValid());
+    REQUIRE_FALSE(MessageTable("1: int").isValid());
+    REQUIRE_FALSE(MessageTable("1: pad").isValid());
+    REQUIRE(MessageTable("1: int").isEmpty());
+    REQUIRE(MessageTable("1: int").indexOf(1) == -1);
+}
+
+TEST_CASE("sample decoder with mixed type layout", "[reader]")
+{
+    // uint16 counter, 2 int16 (big endian), 1 padding byte, int8
+    const char data[] = {0x01, 0x00, 0x00, 0x02, (char) 0xFF, (char) 0xFE, 0x00, (char) 0x80,
+                         0x02, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 0x7F};
+    FrameLayout layout("uint16, 2*int16:be, pad, int8");
+    REQUIRE(layout.size() == 8);
+
+    SampleDecoder decoder(layout, LittleEndian);
+    REQUIRE(decoder.packageSize() == 8);
+
+    SamplePack pack(3, 4);
+    decoder.decode(data, 2, pack, 1);
+    REQUIRE(pack.data(0)[1] == 1);
+    REQUIRE(pack.data(1)[1] == 2);
+    REQUIRE(pack.data(2)[1] == -2);
+    REQUIRE(pack.data(3)[1] == -128);
+    REQUIRE(pack.data(0)[2] == 2);
+    REQUIRE(pack.data(1)[2] == 3);
+    REQUIRE(pack.data(2)[2] == 1);
+    REQUIRE(pack.data(3)[2] == 127);
+
+    // bit fields: 0xD234, low 12 bits, 2 skipped bits, signed 2 bits
+    const char dataBits[] = {0x34, (char) 0xD2};
+    SampleDecoder bitDecoder(FrameLayout("uint16{12|x2|s2}"), LittleEndian);
+    SamplePack bitPack(1, 2);
+    bitDecoder.decode(dataBits, 1, bitPack, 0);
+    REQUIRE(bitPack.data(0)[0] == 0x234);
+    REQUIRE(bitPack.data(1)[0] == -1);
+
+    // default byte order is applied to fields without one
+    decoder = SampleDecoder(layout, BigEndian);
+    decoder.decode(data, 1, pack, 0);
+    REQUIRE(pack.data(0)[0] == 0x0100);
+    REQUIRE(pack.data(1)[0] == 2);
+}
+
+TEST_CASE("device clock unwraps the counter", "[reader]")
+{
+    // 8 bit counter at 100Hz, channel 1 is the clock
+    DeviceClock clock(100, 8);
+    SamplePack in(8, 2);
+    for (unsigned i = 0; i < 8; i++)
+    {
+        in.data(0)[i] = i * 10;
+        in.data(1)[i] = (252 + i) % 256;
+    }
+
+    SamplePack out(8, 1, true);
+    clock.apply(in, 1, out);
+    for (unsigned i = 0; i < 8; i++)
+    {
+        REQUIRE(out.data(0)[i] == i * 10);
+        REQUIRE(out.xData()[i] == Approx(i * 0.01));
+    }
+
+    // continues from the last pack
+    SamplePack out1(1, 1, true);
+    SamplePack in1(1, 2);
+    in1.data(1)[0] = 6;
+    clock.apply(in1, 1, out1);
+    REQUIRE(out1.xData()[0] == Approx(0.10));
+
+    // time continues after reset
+    clock.reset();
+    clock.apply(in, 1, out);
+    REQUIRE(out.xData()[0] == Approx(0.10));
+    REQUIRE(out.xData()[7] == Approx(0.17));
+}
+
+TEST_CASE("device clock corrects drift", "[reader]")
+{
+    // device clock is nominally 1kHz but runs 1% fast
+    const double realRate = 1010;
+    const unsigned ns = 10;
+    DeviceClock clock(1000, 32);
+    SamplePack in(ns, 2);
+    SamplePack out(ns, 1, true);
+
+    double lastX = -1;
+    quint32 counter = 0xFFFFFF00; // wraps during the test
+    for (unsigned k = 1; k <= 1000; k++)
+    {
+        // a pack is received every 10ms
+        qint64 time = qint64(k) * 10000000;
+        for (unsigned i = 0; i < ns; i++)
+        {
+            in.data(1)[i] = i;
+            in.data(0)[i] = quint32(counter + qint64((time * 1e-9 - (ns - 1 - i) / realRate) * realRate));
+        }
+        in.setTimestamp(time, 1e9 / realRate);
+        clock.apply(in, 0, out);
+
+        for (unsigned i = 0; i < ns; i++)
+        {
+            REQUIRE(out.xData()[i] >= lastX);
+            lastX = out.xData()[i];
+        }
+    }
+
+    REQUIRE(clock.tickPeriod() == Approx(1. / realRate).epsilon(1e-4));
+    // device time follows host time
+    REQUIRE(out.xData()[ns-1] == Approx(10 - 0.01).epsilon(1e-3));
+    REQUIRE(out.hasTimestamp());
+}
+
+TEST_CASE("device clock maps the first pack with increasing X", "[reader]")
+{
+    // 1000 samples at 1kHz in a single read
+    const unsigned ns = 1000;
+    DeviceClock clock(1000, 16);
+    SamplePack in(ns, 2);
+    for (unsigned i = 0; i < ns; i++)
+    {
+        in.data(0)[i] = i;
+        in.data(1)[i] = i;
+    }
+    in.setTimestamp(captureTime(), 1e6);
+
+    SamplePack out(ns, 1, true);
+    clock.apply(in, 0, out);
+    REQUIRE(out.xData()[0] == Approx(0).margin(1e-9));
+    for (unsigned i = 1; i < ns; i++)
+    {
+        REQUIRE(out.xData()[i] > out.xData()[i-1]);
+    }
+    REQUIRE(out.xData()[ns-1] == Approx(0.999));
+
+    // next pack arrives early due to timestamp jitter, samples keep
+    // their spacing
+    for (unsigned i = 0; i < ns; i++)
+    {
+        in.data(0)[i] = ns + i;
+    }
+    in.setTimestamp(in.timestamp() + 500000000, 1e6);
+    clock.apply(in, 0, out);
+    REQUIRE(out.xData()[0] >= 0.999);
+    for (unsigned i = 1; i < ns; i++)
+    {
+        REQUIRE(out.xData()[i] > out.xData()[i-1]);
+    }
+}
+
+TEST_CASE("sample decoder into a channel group", "[reader]")
+{
+    const char data[] = {0x01, 0x02, 0x03, 0x04};
+    SampleDecoder decoder(FrameLayout("2*uint8"), LittleEndian);
+
+    SamplePack pack(2, 4);
+    decoder.decodeGroup(data, 2, pack, 0, 1);
+    REQUIRE(pack.data(1)[0] == 1);
+    REQUIRE(pack.data(2)[0] == 2);
+    REQUIRE(pack.data(1)[1] == 3);
+    REQUIRE(pack.data(2)[1] == 4);
+}
+
+TEST_CASE("varint decoder", "[reader]")
+{
+    REQUIRE(VarintDecoder::zigzag(0) == 0);
+    REQUIRE(VarintDecoder::zigzag(1) == -1);
+    REQUIRE(VarintDecoder::zigzag(2) == 1);
+    REQUIRE(VarintDecoder::zigzag(0xFFFFFFFFFFFFFFFFull) == std::numeric_limits<qint64>::min());
+
+    // 2 channels: {0, -1}, {300, 1}
+    const char data[] = {0x00, 0x01, (char) 0xD8, 0x04, 0x02};
+    VarintDecoder decoder(2);
+    REQUIRE(decoder.synced());
+    REQUIRE(decoder.accept(data, 5) == 2);
+
+    SamplePack pack(3, 2);
+    REQUIRE(decoder.decode(data, 5, pack, 1) == 2);
+    REQUIRE(pack.data(0)[1] == 0);
+    REQUIRE(pack.data(1)[1] == -1);
+    REQUIRE(pack.data(0)[2] == 300);
+    REQUIRE(pack.data(1)[2] == 1);
+
+    // truncated varint, odd number of values, too long varint
+    REQUIRE(decoder.accept(data, 3) == -1);
+    REQUIRE(decoder.accept(data, 4) == -1);
+    const char longVarint[] = {(char) 0x80, (char) 0x80, (char) 0x80, (char) 0x80, (char) 0x80,
+                               (char) 0x80, (char) 0x80, (char) 0x80, (char) 0x80, (char) 0x80,
+                               0x01, 0x00};
+    REQUIRE(decoder.accept(longVarint, 12) == -1);
+    REQUIRE(decoder.synced());
+}
+
+TEST_CASE("varint delta decoder resyncs at keyframes", "[reader]")
+{
+    VarintDecoder decoder(2, true);
+    REQUIRE_FALSE(decoder.synced());
+
+    // keyframe {10, -10}, {11, -12}
+    const char keyframe[] = {0x01, 0x14, 0x13, 0x02, 0x03};
+    // delta {+1, +1}
+    const char delta[] = {0x00, 0x02, 0x02};
+
+    SamplePack pack(4, 2);
+    REQUIRE(decoder.accept(delta, 3) == 0); // no keyframe yet
+    REQUIRE(decoder.accept(keyframe, 5) == 2);
+    REQUIRE(decoder.accept(delta, 3) == 1);
+    REQUIRE(decoder.decode(keyframe, 5, pack, 0) == 2);
+    REQUIRE(decoder.decode(delta, 3, pack, 2) == 1);
+    REQUIRE(pack.data(0)[0] == 10);
+    REQUIRE(pack.data(1)[0] == -10);
+    REQUIRE(pack.data(0)[1] == 11);
+    REQUIRE(pack.data(1)[1] == -12);
+    REQUIRE(pack.data(0)[2] == 12);
+    REQUIRE(pack.data(1)[2] == -11);
+
+    // malformed packets break the sync
+    const char badFlag[] = {0x02, 0x02, 0x02};
+    REQUIRE(decoder.accept(badFlag, 3) == -1);
+    REQUIRE_FALSE(decoder.synced());
+    REQUIRE(decoder.accept(delta, 3) == 0);
+    REQUIRE(decoder.accept(keyframe, 5) == 2);
+    REQUIRE(decoder.accept(delta, 2) == -1);
+    REQUIRE(decoder.accept(keyframe, 5) == 2);
+
+    decoder.reset();
+    REQUIRE_FALSE(decoder.synced());
+
+    // reset doesn't change the packets that are already accepted
+    const char keyframe2[] = {0x01, 0x28, 0x27};
+    REQUIRE(decoder.accept(keyframe, 5) == 2);
+    REQUIRE(decoder.accept(delta, 3) == 1);
+    decoder.reset();
+    REQUIRE(decoder.accept(keyframe2, 3) == 1);
+    REQUIRE(decoder.decode(keyframe, 5, pack, 0) == 2);
+    REQUIRE(decoder.decode(delta, 3, pack, 2) == 1);
+    REQUIRE(decoder.decode(keyframe2, 3, pack, 3) == 1);
+    REQUIRE(pack.data(0)[2] == 12);
+    REQUIRE(pack.data(1)[2] == -11);
+    REQUIRE(pack.data(0)[3] == 20);
+    REQUIRE(pack.data(1)[3] == -20);
+}
@@ -8,12 +8,16 @@ class TestSink : public Sink
 {
 public:
     int totalFed;
+    int numFeeds;               ///< number of `feedIn` calls
+    int64_t lastTimestamp;      ///< capture time of the last fed pack
     int _numChannels;
     bool _hasX;
 
     TestSink()
         {
             totalFed = 0;
+            numFeeds = 0;
+            lastTimestamp = -1;
             _numChannels = 0;
             _hasX = false;
         };
@@ -23,6 +27,8 @@ public:
             REQUIRE(data.numChannels() == numChannels());
 
             totalFed += data.numSamples();
+            numFeeds++;
+            lastTimestamp = data.timestamp();
 
             Sink::feedIn(data);
         };
@@ -51,6 +57,7 @@ class TestSource : public Source
 public:
     int _numChannels;
     bool _hasX;
+    NumberFormat _sampleFormat = NumberFormat_INVALID;
 
     TestSource(unsigned nc, bool x)
         {
@@ -68,6 +75,17 @@ public:
             return _hasX;
         };
 
+    virtual NumberFormat sampleFormat() const
+        {
+            return _sampleFormat;
+        };
+
+    void _setSampleFormat(NumberFormat format)
+        {
+            _sampleFormat = format;
+            updateSampleFormat();
+        };
+
     void _feed(const SamplePack& data) const
         {
             feedOut(data);
@@ -23,10 +23,19 @@
 
 #include <QSignalSpy>
 #include <QBuffer>
+#include <QSettings>
+#include <QTemporaryFile>
+#include <string.h>
+#include <vector>
 #include "binarystreamreader.h"
 #include "asciireader.h"
 #include "framedreader.h"
+#include "packetreader.h"
 #include "demoreader.h"
+#include "checksum.h"
+#include "numberparser.h"
+#include "labelindex.h"
+#include "setting_defines.h"
 
 #include "test_helpers.h"
 
@@ -52,6 +61,7 @@ TEST_CASE("reading data with BinaryStreamReader", "[reader]")
     QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
     REQUIRE(spy.wait(READYREAD_TIMEOUT));
     REQUIRE(sink.totalFed == 4);
+    REQUIRE(sink.lastTimestamp >= 0); // stamped with read time
 }
 
 TEST_CASE("disabled BinaryStreamReader shouldn't read", "[reader]")
@@ -100,6 +110,195 @@ TEST_CASE("reading data with AsciiReader", "[reader, ascii]")
     REQUIRE(sink.totalFed == 3);
 }
 
+TEST_CASE("AsciiReader should skip empty and invalid lines", "[reader, ascii]")
+{
+    QBuffer bufferDev;
+    AsciiReader reader(&bufferDev);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    // first line is discarded, last line is incomplete
+    bufferDev.open(QIODevice::ReadWrite);
+    bufferDev.write("0,1\n1.5, -2\r\n\n3,4e1\nx,5\n6,7");
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink._numChannels == 2);
+    REQUIRE(sink.totalFed == 2);
+    REQUIRE(sink.numFeeds == 1);
+}
+
+TEST_CASE("AsciiReader should wait for the rest of a line", "[reader, ascii]")
+{
+    QBuffer bufferDev;
+    AsciiReader reader(&bufferDev);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    // first line is discarded
+    bufferDev.open(QIODevice::ReadWrite);
+    bufferDev.write("0,1\n");
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 0);
+
+    // a read without any complete line
+    qint64 pos = bufferDev.pos();
+    bufferDev.write("1.5,");
+    bufferDev.seek(pos);
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 0);
+    REQUIRE(sink.numFeeds == 0);
+
+    pos = bufferDev.pos();
+    bufferDev.write("-2\n3,4\n");
+    bufferDev.seek(pos);
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink._numChannels == 2);
+    REQUIRE(sink.totalFed == 2);
+}
+
+TEST_CASE("parsing numbers", "[reader, ascii]")
+{
+    auto parse = [](const char* str, double& value)
+        {
+            return parseNumber(str, str + strlen(str), value);
+        };
+
+    double v;
+    REQUIRE(parse("0", v));
+    REQUIRE(v == 0);
+    REQUIRE(parse("-0.5", v));
+    REQUIRE(v == -0.5);
+    REQUIRE(parse(".25", v));
+    REQUIRE(v == 0.25);
+    REQUIRE(parse("+12.", v));
+    REQUIRE(v == 12);
+    REQUIRE(parse("1E-3", v));
+    REQUIRE(v == 0.001);
+    REQUIRE(parse("0.1", v));
+    REQUIRE(v == 0.1);
+    REQUIRE(parse("1e300", v));
+    REQUIRE(v == 1e300);
+    REQUIRE(parse("12345678901234567890.5", v));
+    REQUIRE(v == 12345678901234567890.5);
+
+    REQUIRE_FALSE(parse("", v));
+    REQUIRE_FALSE(parse("-", v));
+    REQUIRE_FALSE(parse("1e", v));
+    REQUIRE_FALSE(parse("1.2.3", v));
+    REQUIRE_FALSE(parse("abc", v));
+}
+
+TEST_CASE("reading labeled data with AsciiReader", "[reader, ascii]")
+{
+    QBuffer bufferDev;
+    AsciiReader reader(&bufferDev);
+
+    // enable labeled mode through settings
+    QTemporaryFile settingsFile;
+    REQUIRE(settingsFile.open());
+    QSettings settings(settingsFile.fileName(), QSettings::IniFormat);
+    settings.beginGroup(SettingGroup_ASCII);
+    settings.setValue(SG_ASCII_Labeled, true);
+    settings.endGroup();
+    reader.loadSettings(&settings);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    QStringList names;
+    QObject::connect(&reader, &AbstractReader::channelNameChanged,
+                     [&names](unsigned channel, QString name)
+                     {
+                         REQUIRE(channel == (unsigned) names.size());
+                         names << name;
+                     });
+
+    bufferDev.open(QIODevice::ReadWrite);
+    bufferDev.write("skipped\ntemp=21.5,rpm=1200\nrpm = 1300\nvolt=3.3,temp=22\n");
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink._numChannels == 3);
+    REQUIRE(sink.totalFed == 3);
+    REQUIRE(names == QStringList({"temp", "rpm", "volt"}));
+}
+
+TEST_CASE("label index", "[reader, ascii]")
+{
+    LabelIndex labels;
+    REQUIRE(labels.size() == 0);
+    REQUIRE(labels.find("temp", 4) == -1);
+
+    // add enough labels to grow the table
+    for (unsigned i = 0; i < 40; i++)
+    {
+        QByteArray label = "ch" + QByteArray::number(i);
+        REQUIRE(labels.insert(label.constData(), label.size()) == i);
+    }
+    REQUIRE(labels.size() == 40);
+
+    for (unsigned i = 0; i < 40; i++)
+    {
+        QByteArray label = "ch" + QByteArray::number(i);
+        REQUIRE(labels.find(label.constData(), label.size()) == (int) i);
+        REQUIRE(labels.label(i) == label);
+    }
+    REQUIRE(labels.find("ch", 2) == -1);
+    REQUIRE(labels.find("ch400", 5) == -1);
+
+    labels.clear();
+    REQUIRE(labels.size() == 0);
+    REQUIRE(labels.find("ch0", 3) == -1);
+}
+
+TEST_CASE("AsciiReader shouldn't learn labels of rejected lines", "[reader, ascii]")
+{
+    QBuffer bufferDev;
+    AsciiReader reader(&bufferDev);
+
+    QTemporaryFile settingsFile;
+    REQUIRE(settingsFile.open());
+    QSettings settings(settingsFile.fileName(), QSettings::IniFormat);
+    settings.beginGroup(SettingGroup_ASCII);
+    settings.setValue(SG_ASCII_Labeled, true);
+    settings.endGroup();
+    reader.loadSettings(&settings);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    QStringList names;
+    QObject::connect(&reader, &AbstractReader::channelNameChanged,
+                     [&names](unsigned channel, QString name)
+                     {
+                         REQUIRE(channel == (unsigned) names.size());
+                         names << name;
+                     });
+
+    // lines with a missing '=' or a bad number are rejected as a whole
+    bufferDev.open(QIODevice::ReadWrite);
+    bufferDev.write("skipped\nbogus=1,temp\nnoise=1,temp=x\ntemp=21.5,rpm=1200\n");
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink._numChannels == 2);
+    REQUIRE(sink.totalFed == 1);
+    REQUIRE(names == QStringList({"temp", "rpm"}));
+}
+
 TEST_CASE("AsciiReader shouldn't read when disabled", "[reader, ascii]")
 {
     QBuffer bufferDev;
@@ -145,6 +344,63 @@ TEST_CASE("reading data with FramedReader", "[reader]")
     REQUIRE(sink.totalFed == 4);
 }
 
+TEST_CASE("FramedReader should skip noise and read multiple frames", "[reader]")
+{
+    QBuffer bufferDev;
+    FramedReader reader(&bufferDev);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    bufferDev.open(QIODevice::ReadWrite);
+    // noise, partial sync word, 2 frames and an incomplete frame
+    const uint8_t data[] = {0x00, 0xAA, 0x12, 0xBB,
+                            0xAA, 0xBB, 2, 0x01, 0x02,
+                            0xAA, 0xBB, 3, 0x01, 0x02, 0x03,
+                            0xAA, 0xBB, 4, 0x01};
+    bufferDev.write((const char*) data, sizeof(data));
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 5);
+    REQUIRE(sink.numFeeds == 1); // frames of a single read are fed together
+}
+
+TEST_CASE("FramedReader should dispatch frames by message ID", "[reader]")
+{
+    QBuffer bufferDev;
+    FramedReader reader(&bufferDev);
+
+    QTemporaryFile settingsFile;
+    REQUIRE(settingsFile.open());
+    QSettings settings(settingsFile.fileName(), QSettings::IniFormat);
+    settings.beginGroup(SettingGroup_CustomFrame);
+    settings.setValue(SG_CustomFrame_Messages, "1: 2*uint8; 0x10: int16");
+    settings.endGroup();
+    reader.loadSettings(&settings);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+    REQUIRE(sink._numChannels == 3);
+
+    bufferDev.open(QIODevice::ReadWrite);
+    // sync word, message ID, size byte, payload
+    const uint8_t data[] = {0xAA, 0xBB, 0x01, 2, 0x0A, 0x0B,
+                            0xAA, 0xBB, 0x10, 2, 0x34, 0x12,
+                            0xAA, 0xBB, 0x05, 1, 0x00, // unknown message
+                            0xAA, 0xBB, 0x01, 4, 0x01, 0x02, 0x03, 0x04};
+    bufferDev.write((const char*) data, sizeof(data));
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 4);
+    REQUIRE(sink.numFeeds == 1);
+}
+
 TEST_CASE("FramedReader shouldn't read when disabled", "[reader]")
 {
     QBuffer bufferDev;
@@ -166,6 +422,164 @@ TEST_CASE("FramedReader shouldn't read when disabled", "[reader]")
     REQUIRE(sink.totalFed == 0);
 }
 
+TEST_CASE("reading COBS packets with PacketReader", "[reader]")
+{
+    QBuffer bufferDev;
+    PacketReader reader(&bufferDev);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    REQUIRE(sink._numChannels == 1);
+
+    bufferDev.open(QIODevice::ReadWrite);
+    // {0x11, 0x00, 0x22}, {0x00}, a malformed and an incomplete packet
+    const uint8_t data[] = {0x02, 0x11, 0x02, 0x22, 0x00,
+                            0x01, 0x01, 0x00,
+                            0x05, 0x11, 0x00,
+                            0x02, 0x33};
+    bufferDev.write((const char*) data, sizeof(data));
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 4);
+    REQUIRE(sink.numFeeds == 1); // packets of a single read are fed together
+}
+
+TEST_CASE("reading SLIP packets with PacketReader", "[reader]")
+{
+    QBuffer bufferDev;
+    PacketReader reader(&bufferDev);
+
+    QTemporaryFile settingsFile;
+    REQUIRE(settingsFile.open());
+    QSettings settings(settingsFile.fileName(), QSettings::IniFormat);
+    settings.beginGroup(SettingGroup_Packet);
+    settings.setValue(SG_Packet_Encoding, "slip");
+    settings.endGroup();
+    reader.loadSettings(&settings);
+    reader.enable(true);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    bufferDev.open(QIODevice::ReadWrite);
+    // {0x01, 0xC0, 0x02}, {0xDB}, a malformed and an incomplete packet
+    const uint8_t data[] = {0xC0,
+                            0x01, 0xDB, 0xDC, 0x02, 0xC0,
+                            0xDB, 0xDD, 0xC0,
+                            0xDB, 0x01, 0xC0,
+                            0x05};
+    bufferDev.write((const char*) data, sizeof(data));
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 4);
+    REQUIRE(sink.numFeeds == 1);
+}
+
+TEST_CASE("reading varint delta packets with PacketReader", "[reader]")
+{
+    QBuffer bufferDev;
+    PacketReader reader(&bufferDev);
+
+    QTemporaryFile settingsFile;
+    REQUIRE(settingsFile.open());
+    QSettings settings(settingsFile.fileName(), QSettings::IniFormat);
+    settings.beginGroup(SettingGroup_Packet);
+    settings.setValue(SG_Packet_Compression, "varintdelta");
+    settings.endGroup();
+    reader.loadSettings(&settings);
+    reader.enable(true);
+
+    REQUIRE(reader.sampleFormat() == NumberFormat_INVALID);
+
+    TestSink sink;
+    reader.connectSink(&sink);
+
+    bufferDev.open(QIODevice::ReadWrite);
+    // COBS encoded: delta {+1} (skipped, no keyframe yet), keyframe
+    // {10, 11}, delta {+1}, a packet with a bad flag and delta {+1}
+    // (skipped, sync is lost)
+    const uint8_t data[] = {0x01, 0x02, 0x02, 0x00,
+                            0x04, 0x01, 0x14, 0x02, 0x00,
+                            0x01, 0x02, 0x02, 0x00,
+                            0x03, 0x05, 0x02, 0x00,
+                            0x01, 0x02, 0x02, 0x00};
+    bufferDev.write((const char*) data, sizeof(data));
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.totalFed == 3);
+    REQUIRE(sink.numFeeds == 1);
+}
+
+TEST_CASE("PacketReader should keep delta packets before a malformed packet", "[reader]")
+{
+    /// Stores all fed samples of first channel
+    class CopySink : public TestSink
+    {
+    public:
+        std::vector<double> y;
+
+        void feedIn(const SamplePack& data)
+            {
+                y.insert(y.end(), data.data(0), data.data(0) + data.numSamples());
+                TestSink::feedIn(data);
+            };
+    };
+
+    QBuffer bufferDev;
+    PacketReader reader(&bufferDev);
+
+    QTemporaryFile settingsFile;
+    REQUIRE(settingsFile.open());
+    QSettings settings(settingsFile.fileName(), QSettings::IniFormat);
+    settings.beginGroup(SettingGroup_Packet);
+    settings.setValue(SG_Packet_Compression, "varintdelta");
+    settings.endGroup();
+    reader.loadSettings(&settings);
+    reader.enable(true);
+
+    CopySink sink;
+    reader.connectSink(&sink);
+
+    bufferDev.open(QIODevice::ReadWrite);
+    // COBS encoded in a single read: keyframe {10, 11}, delta {+1}, a
+    // malformed packet and keyframe {20}
+    const uint8_t data[] = {0x04, 0x01, 0x14, 0x02, 0x00,
+                            0x01, 0x02, 0x02, 0x00,
+                            0x05, 0x11, 0x00,
+                            0x03, 0x01, 0x28, 0x00};
+    bufferDev.write((const char*) data, sizeof(data));
+    bufferDev.seek(0);
+
+    QSignalSpy spy(&bufferDev, SIGNAL(readyRead()));
+    REQUIRE(spy.wait(READYREAD_TIMEOUT));
+    REQUIRE(sink.y == std::vector<double>({10, 11, 12, 20}));
+}
+
+TEST_CASE("checksum check values", "[reader]")
+{
+    const char data[] = "123456789";
+
+    REQUIRE(Checksum(ChecksumType_Sum8).calculate(data, 9) == 0xDD);
+    REQUIRE(Checksum(ChecksumType_CRC8).calculate(data, 9) == 0xF4);
+    REQUIRE(Checksum(ChecksumType_CRC16_CCITT).calculate(data, 9) == 0x29B1);
+    REQUIRE(Checksum(ChecksumType_CRC16_Modbus).calculate(data, 9) == 0x4B37);
+    REQUIRE(Checksum(ChecksumType_CRC32).calculate(data, 9) == 0xCBF43926);
+
+    // custom parameters: CRC-16/KERMIT and CRC-16/XMODEM
+    REQUIRE(Checksum(ChecksumType_CRC16_CCITT, 0, 0, true).calculate(data, 9) == 0x2189);
+    REQUIRE(Checksum(ChecksumType_CRC16_CCITT, 0, 0, false).calculate(data, 9) == 0x31C3);
+
+    REQUIRE(Checksum(ChecksumType_CRC32).size() == 4);
+}
+
 TEST_CASE("Generating data with DemoReader", "[reader, demo]")
 {
     QBuffer bufferDev;          // not actually used
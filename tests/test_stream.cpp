@@ -64,8 +64,6 @@ TEST_CASE("changing stream number of channels via sink", "[memory, stream, sink]
         REQUIRE(c->index() == i);
     }
 
-// TODO: enable test when `Stream` supports X channel
-#if 0
     // increase nc value, add X
     so._setNumChannels(5, true);
 
@@ -78,7 +76,6 @@ TEST_CASE("changing stream number of channels via sink", "[memory, stream, sink]
         REQUIRE(c != NULL);
         REQUIRE(c->index() == i);
     }
-#endif
 
     // reduce nc value, remove X
     so._setNumChannels(1, false);
@@ -94,6 +91,34 @@ TEST_CASE("changing stream number of channels via sink", "[memory, stream, sink]
     }
 }
 
+TEST_CASE("stream should notify when X buffer is replaced", "[memory, stream, sink]")
+{
+    Stream s(2, false, 10);
+    TestSource so(2, false);
+    so.connectSink(&s);
+
+    unsigned numChanges = 0;
+    QObject::connect(&s, &Stream::buffersChanged, [&numChanges]() {numChanges++;});
+
+    // X axis is re-created
+    s.setXAxis(false, 0, 10);
+    REQUIRE(numChanges == 1);
+    REQUIRE(s.channel(0)->xData()->size() == 10);
+
+    // source starts providing X
+    so._setNumChannels(2, true);
+    REQUIRE(numChanges == 2);
+    REQUIRE(s.channel(1)->xData()->size() == 10);
+
+    // X is ignored when provided by source
+    s.setXAxis(true, 0, 10);
+    REQUIRE(numChanges == 2);
+
+    so._setNumChannels(2, false);
+    REQUIRE(numChanges == 3);
+    REQUIRE(s.channel(1)->xData()->size() == 10);
+}
+
 TEST_CASE("adding data to a stream with no X", "[memory, stream, data, sink]")
 {
     Stream s(3, false, 10);
@@ -130,8 +155,6 @@ TEST_CASE("adding data to a stream with no X", "[memory, stream, data, sink]")
     }
 }
 
-// TODO: enable test when `Stream` supports X channel
-#if 0
 TEST_CASE("adding data to a stream with X", "[memory, stream, data, sink]")
 {
     Stream s(3, false, 10);
@@ -152,7 +175,8 @@ TEST_CASE("adding data to a stream with X", "[memory, stream, data, sink]")
     }
 
     TestSource so(3, true);
-    REQUIRE_THROWS(so.connectSink(&s));
+    so.connectSink(&s);
+    REQUIRE(s.hasX());
 
     // test
     so._feed(pack);
@@ -182,8 +206,11 @@ TEST_CASE("adding data to a stream with X", "[memory, stream, data, sink]")
     {
         REQUIRE(x->sample(i) == (i-5)+10);
     }
+
+    // X is searchable
+    REQUIRE(s.channel(0)->xData()->findIndex(12.5) == 7);
+    REQUIRE(s.channel(0)->findValue(12.5) == 2.5);
 }
-#endif
 
 TEST_CASE("paused stream shouldn't store data", "[memory, stream, pause]")
 {
@@ -250,3 +277,126 @@ TEST_CASE("clear stream data", "[memory, stream, pause]")
         }
     }
 }
+
+TEST_CASE("stream stores samples in source format", "[memory, stream, sink]")
+{
+    Stream s(2, false, 10);
+    TestSource so(2, false);
+    so.connectSink(&s);
+
+    SamplePack pack(5, 2, false);
+    for (unsigned ci = 0; ci < 2; ci++)
+    {
+        for (unsigned i = 0; i < 5; i++)
+        {
+            pack.data(ci)[i] = i + 0.5;
+        }
+    }
+
+    // default is double
+    so._feed(pack);
+    REQUIRE(s.channel(0)->yData()->sample(9) == 4.5);
+
+    // existing data is converted when storage changes
+    so._setSampleFormat(NumberFormat_int16);
+    for (unsigned ci = 0; ci < 2; ci++)
+    {
+        const FrameBuffer* y = s.channel(ci)->yData();
+        for (unsigned i = 5; i < 10; i++)
+        {
+            REQUIRE(y->sample(i) == i-5);
+        }
+    }
+
+    so._setSampleFormat(NumberFormat_float);
+    so._feed(pack);
+    REQUIRE(s.channel(1)->yData()->sample(4) == 4);
+    REQUIRE(s.channel(1)->yData()->sample(9) == 4.5);
+}
+
+TEST_CASE("stream history", "[memory, stream, history]")
+{
+    Stream s(1, false, 4);
+    TestSource so(1, false);
+    so.connectSink(&s);
+
+    REQUIRE(!s.hasHistory());
+    s.setHistoryEnabled(true);
+    REQUIRE(s.hasHistory());
+
+    const StreamChannel* c = s.channel(0);
+    REQUIRE(c->yHistory() != nullptr);
+    REQUIRE(c->xHistory() != nullptr);
+
+    // initial zeros shouldn't go into history
+    SamplePack pack(3, 1, false);
+    for (unsigned i = 0; i < 3; i++) pack.data(0)[i] = i;
+    so._feed(pack);
+    REQUIRE(c->yHistory()->size() == 4);
+
+    for (unsigned i = 0; i < 3; i++) pack.data(0)[i] = i + 3;
+    so._feed(pack);
+    REQUIRE(c->yHistory()->size() == 6);
+
+    // bigger than buffer size
+    SamplePack pack2(6, 1, false);
+    for (unsigned i = 0; i < 6; i++) pack2.data(0)[i] = i + 6;
+    so._feed(pack2);
+
+    auto y = c->yHistory();
+    REQUIRE(y->size() == 12);
+    for (unsigned i = 0; i < 12; i++)
+    {
+        REQUIRE(y->sample(i) == i);
+    }
+    auto lim = y->limits(1, 3);
+    REQUIRE(lim.start == 1);
+    REQUIRE(lim.end == 3);
+
+    // history X continues backwards from the buffer X
+    auto x = c->xHistory();
+    REQUIRE(x->sample(0) == -8);
+    REQUIRE(x->sample(11) == 3);
+    REQUIRE(x->findIndex(-1.5) == 6);
+
+    s.clear();
+    REQUIRE(c->yHistory()->size() == 4);
+
+    s.setHistoryEnabled(false);
+    REQUIRE(!s.hasHistory());
+    REQUIRE(c->yHistory() == nullptr);
+}
+
+TEST_CASE("stream history in memory", "[memory, stream, history]")
+{
+    Stream s(2, false, 4);
+    TestSource so(2, false);
+    so.connectSink(&s);
+
+    s.setHistoryInMemory(true);
+    s.setHistoryEnabled(true);
+    REQUIRE(s.hasHistory());
+
+    const unsigned N = 5000;
+    SamplePack pack(N, 2, false);
+    for (unsigned i = 0; i < N; i++)
+    {
+        pack.data(0)[i] = i;
+        pack.data(1)[i] = i / 3.;
+    }
+    so._feed(pack);
+
+    auto y = s.channel(1)->yHistory();
+    REQUIRE(y->size() == N);
+    for (unsigned i = 0; i < N; i++)
+    {
+        REQUIRE(s.channel(0)->yHistory()->sample(i) == i);
+        REQUIRE(y->sample(i) == i / 3.);
+    }
+    REQUIRE(y->limits().end == (N - 1) / 3.);
+
+    // switching storage discards history
+    s.setHistoryInMemory(false);
+    REQUIRE(s.hasHistory());
+    REQUIRE(s.channel(0)->yHistory()->size() == 4);
+}